@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "end_index.hpp"
+#include "inflection_map.hpp"
+#include "kmer.hpp"
+#include "oligo_dictionary.hpp"
+#include "sequence.hpp"
+#include "sequence_vector.hpp"
+#include "spectrum_generator.hpp"
+#include <omp.h>
+
+namespace {
+
+constexpr uint8_t oligo_length = 10;
+constexpr int warmup_runs = 1;
+constexpr int sample_runs = 5;
+
+size_t sink = 0;
+
+struct spectrum {
+    oligo_dictionary dictionary;
+    std::vector<uint32_t> ordered;
+    std::vector<uint32_t> words;
+    unsigned int origin_length;
+};
+
+spectrum make_spectrum(const size_t size) {
+    spectrum_generator generator(oligo_length);
+    const std::string origin = generator.origin(size + oligo_length - 1);
+
+    spectrum result;
+    result.origin_length = origin.size();
+    for (const auto& oligo : generator.oligos(origin)) {
+        result.ordered.push_back(result.dictionary.intern(kmer(oligo)));
+    }
+    for (const auto& oligo : generator.spectrum(origin, spectrum_generator::errors::negative, size / 20)) {
+        result.words.push_back(result.dictionary.intern(kmer(oligo)));
+    }
+    std::shuffle(result.words.begin(), result.words.end(), std::mt19937(size));
+    return result;
+}
+
+// Compares end_index::overlaps against an all-pairs is_prefix scan for a sample of backs.
+void check_overlaps(const spectrum& input, const size_t samples = 200) {
+    const oligo_dictionary& dictionary = input.dictionary;
+    const end_index ends(dictionary, input.words, input.words);
+    std::vector<uint8_t> present(dictionary.size());
+    for (const uint32_t word : input.words) {
+        present[word] = true;
+    }
+    for (size_t i = 0; i < std::min(samples, input.words.size()); ++i) {
+        const uint32_t back = input.words[i];
+        std::vector<std::pair<uint32_t, uint8_t>> expected;
+        for (uint32_t front = 0; front < dictionary.size(); ++front) {
+            if (!present[front]) continue;
+            for (uint8_t offset = 1; offset < dictionary[back].length(); ++offset) {
+                if (!inflection_map::is_prefix(dictionary[front], dictionary[back], offset)) continue;
+                expected.emplace_back(front, dictionary[back].length() - offset);
+                break;
+            }
+        }
+        auto found = ends.overlaps(back);
+        std::ranges::sort(expected);
+        std::ranges::sort(found);
+        if (found != expected) {
+            throw std::logic_error("end_index::overlaps disagrees with is_prefix for " + dictionary[back].to_string());
+        }
+    }
+}
+
+// Removing every node of a map without edges must leave it empty without refilling it on each removal.
+void check_edgeless_removal(const spectrum& input) {
+    inflection_map map(input.dictionary, {}, input.words, 1);
+    for (const uint32_t word : input.words) {
+        map.remove(word);
+    }
+    if (std::ranges::any_of(input.words, [&](const uint32_t word) { return map.contains(word); })) {
+        throw std::logic_error("inflection_map::remove left nodes of an edgeless map alive");
+    }
+}
+
+template<typename Setup, typename Run>
+void measure(const std::string& name, const size_t size, const int threads, const Setup& setup, const Run& run) {
+    omp_set_num_threads(threads);
+    std::vector<double> samples;
+    for (int attempt = 0; attempt < warmup_runs + sample_runs; ++attempt) {
+        auto state = setup();
+        const auto start = std::chrono::high_resolution_clock::now();
+        run(state);
+        const auto end = std::chrono::high_resolution_clock::now();
+        if (attempt >= warmup_runs) samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    std::cout << std::left << std::setw(36) << name << std::right
+        << std::setw(10) << size << std::setw(8) << threads
+        << std::setw(14) << std::fixed << std::setprecision(1) << samples[samples.size() / 2]
+        << std::setw(14) << samples.front() << std::endl;
+}
+
+void run_kernels(const spectrum& input, const int threads) {
+    const size_t size = input.ordered.size();
+    const oligo_dictionary& dictionary = input.dictionary;
+
+    measure("inflection_map::is_prefix", size, threads, [] { return 0; }, [&](int&) {
+        size_t found = 0;
+        #pragma omp parallel for reduction(+:found)
+        for (size_t position = 1; position < input.words.size(); ++position) {
+            found += inflection_map::is_prefix(dictionary[input.words[position - 1]], dictionary[input.words[position]], 1);
+        }
+        sink += found;
+    });
+
+    measure("inflection_map(lines)", size, threads, [] { return 0; }, [&](int&) {
+        const inflection_map map(dictionary, input.words, 1);
+        sink += map.contains(input.words.front());
+    });
+
+    measure("inflection_map(prefixes, suffixes)", size, threads, [] { return 0; }, [&](int&) {
+        const inflection_map map(dictionary, input.words, input.words, 1);
+        sink += map.contains(input.words.front());
+    });
+
+    measure("inflection_map::remove", size, threads, [&] { return inflection_map(dictionary, input.words, 1); }, [&](inflection_map& map) {
+        for (const uint32_t word : input.words) {
+            map.remove(word);
+        }
+    });
+
+    measure("inflection_map::remove(edgeless)", size, threads, [&] { return inflection_map(dictionary, {}, input.words, 1); }, [&](inflection_map& map) {
+        for (const uint32_t word : input.words) {
+            map.remove(word);
+        }
+    });
+
+    measure("sequence_vector(words)", size, threads, [] { return 0; }, [&](int&) {
+        const sequence_vector sequences(dictionary, input.words, input.origin_length);
+        sink += sequences.size();
+    });
+
+    measure("sequence_vector::merge", size, threads, [&] {
+        auto sequences = std::make_unique<sequence_vector>(dictionary, input.words, input.origin_length);
+        auto ends = std::make_unique<end_index>(dictionary, sequences->fronts(), sequences->backs());
+        return std::make_pair(std::move(sequences), std::move(ends));
+    }, [&](auto& state) {
+        for (int offset = 2; offset < oligo_length; ++offset) {
+            state.first->merge(*state.second, offset);
+        }
+        sink += state.first->size();
+    });
+
+    measure("sequence::to_string", size, threads, [&] {
+        sequence assembled(dictionary, input.ordered.front());
+        for (size_t position = 1; position < input.ordered.size(); ++position) {
+            assembled.add_back(input.ordered[position], 1);
+        }
+        return assembled;
+    }, [&](const sequence& assembled) {
+        sink += assembled.to_string().size();
+    });
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {1000, 10000, 100000};
+    if (argc > 1) {
+        sizes.clear();
+        for (int argument = 1; argument < argc; ++argument) {
+            sizes.push_back(std::stoul(argv[argument]));
+        }
+    }
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < omp_get_max_threads(); threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(omp_get_max_threads());
+
+    std::cout << std::left << std::setw(36) << "jądro" << std::right << std::setw(10) << "rozmiar" << std::setw(8) << "wątki"
+        << std::setw(14) << "mediana(us)" << std::setw(14) << "min(us)" << std::endl;
+    for (const size_t size : sizes) {
+        const spectrum input = make_spectrum(size);
+        check_overlaps(input);
+        check_edgeless_removal(input);
+        for (const int threads : thread_counts) {
+            run_kernels(input, threads);
+        }
+    }
+    return sink > 0 ? 0 : 1;
+}
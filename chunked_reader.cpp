@@ -0,0 +1,15 @@
+#include <stdexcept>
+#include "chunked_reader.hpp"
+
+chunked_reader::chunked_reader(const std::string& filename, const size_t chunk_size)
+    : input_file(filename, std::ios::binary), chunk_size(chunk_size) {
+    if (!input_file) {
+        throw std::runtime_error("Cannot open " + filename + "\n");
+    }
+}
+
+void chunked_reader::read(std::string& chunk) {
+    chunk.resize(chunk_size);
+    input_file.read(chunk.data(), static_cast<std::streamsize>(chunk_size));
+    chunk.resize(input_file.gcount());
+}
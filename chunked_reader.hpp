@@ -0,0 +1,57 @@
+#ifndef CHUNKED_READER_HPP
+#define CHUNKED_READER_HPP
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include "tracer.hpp"
+
+class chunked_reader {
+
+    std::ifstream input_file;
+    size_t chunk_size;
+
+    void read(std::string& chunk);
+
+public:
+
+    explicit chunked_reader(const std::string& filename, size_t chunk_size = size_t{1} << 20);
+
+    template<typename Consumer>
+    void for_each_line(const Consumer& consume);
+};
+
+template<typename Consumer>
+void chunked_reader::for_each_line(const Consumer& consume) {
+    std::string current, next;
+    read(current);
+
+    #pragma omp parallel num_threads(2)
+    #pragma omp single
+    while (!current.empty()) {
+        #pragma omp task shared(next)
+        {
+            const tracer::scope trace("chunked_reader::read");
+            read(next);
+        }
+
+        std::string_view text = current;
+        for (size_t end = text.find('\n'); end != std::string_view::npos; end = text.find('\n')) {
+            std::string_view line = text.substr(0, end);
+            if (line.ends_with('\r')) line.remove_suffix(1);
+            consume(line);
+            text.remove_prefix(end + 1);
+        }
+
+        #pragma omp taskwait
+        if (next.empty()) {
+            if (text.ends_with('\r')) text.remove_suffix(1);
+            if (!text.empty()) consume(text);
+            break;
+        }
+        current = std::string(text) + next;
+        next.clear();
+    }
+}
+
+#endif //CHUNKED_READER_HPP
@@ -0,0 +1,25 @@
+#include <numeric>
+#include <utility>
+#include "disjoint_set.hpp"
+
+disjoint_set::disjoint_set(const size_t count) : parents(count), ranks(count) {
+    std::iota(parents.begin(), parents.end(), 0);
+}
+
+uint32_t disjoint_set::find(uint32_t element) {
+    while (parents[element] != element) {
+        parents[element] = parents[parents[element]];
+        element = parents[element];
+    }
+    return element;
+}
+
+bool disjoint_set::unite(uint32_t first, uint32_t second) {
+    first = find(first);
+    second = find(second);
+    if (first == second) return false;
+    if (ranks[first] < ranks[second]) std::swap(first, second);
+    parents[second] = first;
+    if (ranks[first] == ranks[second]) ++ranks[first];
+    return true;
+}
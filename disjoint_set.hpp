@@ -0,0 +1,26 @@
+#ifndef DISJOINT_SET_HPP
+#define DISJOINT_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class disjoint_set {
+
+    std::vector<uint32_t> parents;
+    std::vector<uint8_t> ranks;
+
+public:
+
+    explicit disjoint_set(size_t count);
+
+    [[nodiscard]] uint32_t find(uint32_t element);
+
+    bool unite(uint32_t first, uint32_t second);
+
+    [[nodiscard]] bool connected(const uint32_t first, const uint32_t second) { return find(first) == find(second); }
+
+    [[nodiscard]] size_t size() const { return parents.size(); }
+};
+
+#endif //DISJOINT_SET_HPP
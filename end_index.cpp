@@ -0,0 +1,60 @@
+#include <algorithm>
+#include "end_index.hpp"
+#include "tracer.hpp"
+
+end_index::end_index(const oligo_dictionary& dictionary, const std::vector<uint32_t>& fronts, const std::vector<uint32_t>& backs)
+    : dictionary(&dictionary),
+      fronts_by_head(sorted(fronts, [&](const uint32_t front) { return dictionary[front]; })),
+      backs_by_tail(sorted(backs, [&](const uint32_t back) { return dictionary[back].reversed(); })),
+      front_alive(dictionary.size()), back_alive(dictionary.size()) {
+
+    for (const uint32_t front : fronts) {
+        front_alive[front] = true;
+    }
+    for (const uint32_t back : backs) {
+        back_alive[back] = true;
+    }
+}
+
+std::vector<end_index::entry> end_index::sorted(const std::vector<uint32_t>& ends, const auto& key) {
+    std::vector<entry> entries(ends.size());
+
+    #pragma omp parallel
+    {
+        const tracer::scope trace("end_index::keys");
+        #pragma omp for nowait
+        for (size_t i = 0; i < ends.size(); ++i) {
+            entries[i] = entry(key(ends[i]).value(), ends[i]);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
+        return a.key == b.key ? a.end < b.end : a.key < b.key;
+    });
+    return entries;
+}
+
+std::pair<size_t, size_t> end_index::bounds(const std::vector<entry>& entries, const kmer& probe, const uint8_t overlap) {
+    if (overlap == 0 or overlap > probe.length()) return {0, 0};
+    const uint64_t low = probe.tail(overlap).padded(probe.length()).value();
+    const uint64_t high = low + (uint64_t{1} << 2 * (probe.length() - overlap));
+    const auto first = std::ranges::lower_bound(entries, low, {}, &entry::key);
+    const auto last = std::ranges::lower_bound(first, entries.end(), high, {}, &entry::key);
+    return {first - entries.begin(), last - entries.begin()};
+}
+
+std::vector<std::pair<uint32_t, uint8_t>> end_index::overlaps(const uint32_t back) const {
+    std::vector<std::pair<uint32_t, uint8_t>> partners;
+    const kmer& oligo = (*dictionary)[back];
+
+    // Each overlap length probes its own suffix, so the ranges are unrelated;
+    // scanning from the longest overlap down keeps the first (largest) one per front.
+    for (uint8_t overlap = oligo.length() - 1; overlap > 0; --overlap) {
+        for (const uint32_t front : alive(fronts_by_head, bounds(fronts_by_head, oligo, overlap), front_alive)) {
+            partners.emplace_back(front, overlap);
+        }
+    }
+    std::ranges::stable_sort(partners, {}, &std::pair<uint32_t, uint8_t>::first);
+    const auto duplicates = std::ranges::unique(partners, {}, &std::pair<uint32_t, uint8_t>::first);
+    partners.erase(duplicates.begin(), duplicates.end());
+    return partners;
+}
@@ -0,0 +1,56 @@
+#ifndef END_INDEX_HPP
+#define END_INDEX_HPP
+
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+#include "kmer.hpp"
+#include "oligo_dictionary.hpp"
+
+class end_index {
+
+    struct entry {
+        uint64_t key;
+        uint32_t end;
+    };
+
+    const oligo_dictionary* dictionary;
+    std::vector<entry> fronts_by_head, backs_by_tail;
+    std::vector<uint8_t> front_alive, back_alive;
+
+    static std::vector<entry> sorted(const std::vector<uint32_t>& ends, const auto& key);
+
+    [[nodiscard]] static std::pair<size_t, size_t> bounds(const std::vector<entry>& entries, const kmer& probe, uint8_t overlap);
+
+    [[nodiscard]] static auto alive(const std::vector<entry>& entries, const std::pair<size_t, size_t>& range, const std::vector<uint8_t>& flags) {
+        return std::span(entries).subspan(range.first, range.second - range.first)
+            | std::views::filter([&flags](const entry& candidate) { return flags[candidate.end] != 0; })
+            | std::views::transform(&entry::end);
+    }
+
+public:
+
+    end_index(const oligo_dictionary& dictionary, const std::vector<uint32_t>& fronts, const std::vector<uint32_t>& backs);
+
+    [[nodiscard]] auto following(const uint32_t back, const uint8_t offset) const {
+        const kmer& oligo = (*dictionary)[back];
+        return alive(fronts_by_head, bounds(fronts_by_head, oligo, oligo.length() > offset ? oligo.length() - offset : 0), front_alive);
+    }
+
+    [[nodiscard]] auto preceding(const uint32_t front, const uint8_t offset) const {
+        const kmer oligo = (*dictionary)[front].reversed();
+        return alive(backs_by_tail, bounds(backs_by_tail, oligo, oligo.length() > offset ? oligo.length() - offset : 0), back_alive);
+    }
+
+    [[nodiscard]] std::vector<std::pair<uint32_t, uint8_t>> overlaps(uint32_t back) const;
+
+    void insert_back(const uint32_t back) { back_alive[back] = true; }
+
+    void erase_front(const uint32_t front) { front_alive[front] = false; }
+
+    void erase_back(const uint32_t back) { back_alive[back] = false; }
+};
+
+#endif //END_INDEX_HPP
@@ -0,0 +1,49 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include "spectrum_generator.hpp"
+
+void write_lines(const std::filesystem::path& filename, const std::vector<std::string>& lines) {
+    std::ofstream output(filename);
+    if (!output) {
+        throw std::runtime_error("Cannot open " + filename.string() + "\n");
+    }
+    for (const auto& line : lines) {
+        output << line << '\n';
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << "użycie: " << argv[0] << " <długość> <none|repeats|negative|ends|positive> <liczba błędów> <katalog> [długość oligo] [ziarno]" << std::endl;
+        return 1;
+    }
+    const size_t length = std::stoul(argv[1]);
+    const spectrum_generator::errors kind = spectrum_generator::parse(argv[2]);
+    const size_t count = std::stoul(argv[3]);
+    const std::filesystem::path directory = argv[4];
+    const auto oligo_length = static_cast<uint8_t>(argc > 5 ? std::stoul(argv[5]) : 10);
+    const uint64_t seed = argc > 6 ? std::stoull(argv[6]) : 2024;
+
+    spectrum_generator generator(oligo_length, seed);
+    const std::string origin = generator.origin(length, kind, count);
+    const std::vector<std::string> spectrum = generator.spectrum(origin, kind, count);
+
+    // The name carries the errors actually introduced, not the requested count: repeats lose a
+    // varying number of windows, and positive insertions can run out of attempts.
+    const bool positive = kind == spectrum_generator::errors::ends or kind == spectrum_generator::errors::positive;
+    const std::vector<std::string> windows = generator.oligos(origin);
+    const size_t distinct = std::set(windows.begin(), windows.end()).size();
+    size_t introduced = 0;
+    if (positive) introduced = spectrum.size() - distinct;
+    else if (kind != spectrum_generator::errors::none) introduced = windows.size() - spectrum.size();
+    const std::string name = std::to_string(seed) + "." + std::to_string(length) + (positive ? "+" : "-") + std::to_string(introduced) + ".txt";
+    std::filesystem::create_directories(directory / "reference");
+    write_lines(directory / name, spectrum);
+    write_lines(directory / "reference" / name, {origin});
+    std::cout << directory / name << '\t' << spectrum.size() << " oligo" << std::endl;
+    return 0;
+}
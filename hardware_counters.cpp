@@ -0,0 +1,76 @@
+#include <stdexcept>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "hardware_counters.hpp"
+
+namespace {
+    std::array<int, hardware_counters::event_count> descriptors = [] {
+        std::array<int, hardware_counters::event_count> closed {};
+        closed.fill(-1);
+        return closed;
+    }();
+    bool active = false;
+
+    perf_event_attr attributes(const hardware_counters::event counter) {
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        switch (counter) {
+            case hardware_counters::cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case hardware_counters::instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case hardware_counters::l1d_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+                break;
+            case hardware_counters::llc_misses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            default:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+        }
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return attr;
+    }
+}
+
+void hardware_counters::open() {
+    for (uint8_t counter = 0; counter < event_count; ++counter) {
+        perf_event_attr attr = attributes(static_cast<event>(counter));
+        descriptors[counter] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        active = active or descriptors[counter] >= 0;
+    }
+    if (!active) {
+        throw std::runtime_error("Cannot open hardware counters (check /proc/sys/kernel/perf_event_paranoid)\n");
+    }
+}
+
+bool hardware_counters::opened() {
+    return active;
+}
+
+bool hardware_counters::available(const event counter) {
+    return descriptors[counter] >= 0;
+}
+
+hardware_counters::values hardware_counters::read() {
+    values counts {};
+    for (uint8_t counter = 0; counter < event_count; ++counter) {
+        uint64_t value[3] {};
+        if (descriptors[counter] < 0 or ::read(descriptors[counter], value, sizeof(value)) != sizeof(value)) continue;
+        // Scale up when the kernel had to multiplex more events than there are counters.
+        counts[counter] = value[2] == 0 ? 0 : static_cast<uint64_t>(static_cast<double>(value[0]) * value[1] / value[2]);
+    }
+    return counts;
+}
@@ -0,0 +1,31 @@
+#ifndef HARDWARE_COUNTERS_HPP
+#define HARDWARE_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+class hardware_counters {
+
+public:
+
+    enum event : uint8_t { cycles, instructions, l1d_misses, llc_misses, branch_misses, event_count };
+
+    using values = std::array<uint64_t, event_count>;
+
+    static constexpr std::array<std::string_view, event_count> names = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+    };
+
+    // Counters are process-wide and inherited by threads created later, so this
+    // has to run before the first parallel region spawns the OpenMP pool.
+    static void open();
+
+    [[nodiscard]] static bool opened();
+
+    [[nodiscard]] static bool available(event counter);
+
+    [[nodiscard]] static values read();
+};
+
+#endif //HARDWARE_COUNTERS_HPP
@@ -1,100 +1,182 @@
-#include <ranges>
-#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include "inflection_map.hpp"
+#include "tracer.hpp"
 #include <omp.h>
-#include <map>
 
-inflection_map::inflection_vectors::inflection_vectors(const auto& begin, const auto& end)
-    : prefixes(std::make_shared<std::vector<std::string>>(begin, end)),
-      suffixes(std::make_shared<std::vector<std::string>>()),
-      keys() {}
+namespace {
+    const std::vector<uint32_t> none;
 
-inflection_map::inflection_vectors::inflection_vectors ()
-    : prefixes(std::make_shared<std::vector<std::string>>()),
-      suffixes(std::make_shared<std::vector<std::string>>()),
-      keys() {}
-
-inflection_map::inflection_map(const std::vector<std::string>& lines, uint8_t offset) {
-
-    #pragma omp parallel for
-    for (auto it = lines.begin(); it != lines.end(); ++it ) {
-        const std::string &text = *it;
-        auto range = lines | std::views::filter([&](const std::string &line) {
-            return is_prefix(text, line, offset);
-        });
-        #pragma omp critical
-        {
-            inflection_vectors_map.emplace(text, inflection_vectors(range.begin(), range.end()));
+    template<typename Neighbours>
+    uint32_t only(Neighbours&& neighbours, const uint32_t node, const uint32_t missing) {
+        uint32_t found = missing;
+        for (const uint32_t neighbour : neighbours) {
+            if (found == missing) found = neighbour;
+            else if (neighbour != found) return missing;
         }
+        return found == node ? missing : found;
     }
 
-    #pragma omp parallel for
-    for (const std::string& text: lines) {
-        const auto prefixes_ptr = inflection_vectors_map.at(text).prefixes;
-        for (const auto& prefix : *prefixes_ptr) {
-            #pragma omp critical
+    template<typename Combine>
+    void jump(std::vector<uint32_t>& pointers, std::vector<uint32_t>& values, const Combine& combine) {
+        std::vector<uint32_t> jumped_pointers(pointers.size()), jumped_values(values.size());
+        for (size_t span = 1; span < pointers.size(); span <<= 1) {
+            #pragma omp parallel
             {
-                inflection_vectors_map.at(prefix).keys.push_back(prefixes_ptr);
-                inflection_vectors_map.at(prefix).suffixes->push_back(text);
-                inflection_vectors_map.at(text).keys.push_back(inflection_vectors_map.at(prefix).suffixes);
+                const tracer::scope trace("inflection_map::jump");
+                #pragma omp for nowait
+                for (size_t node = 0; node < pointers.size(); ++node) {
+                    jumped_values[node] = combine(values[node], values[pointers[node]]);
+                    jumped_pointers[node] = pointers[pointers[node]];
+                }
             }
+            pointers.swap(jumped_pointers);
+            values.swap(jumped_values);
         }
     }
 }
 
-inflection_map::inflection_map(const std::vector<std::string> &potential_prefixes, const std::vector<std::string> &potential_suffixes, uint8_t offset) {
+inflection_map::inflection_map(const oligo_dictionary& dictionary, const std::vector<uint32_t>& lines, uint8_t offset)
+    : inflection_map(dictionary, lines, overlap_index(dictionary, lines, offset)) {}
 
-    #pragma omp parallel for
-    for (const std::string& text : potential_suffixes) {
-        auto range = potential_prefixes | std::views::filter([&](const std::string& word) {
-            return is_prefix(text, word, offset);
-        });
-
-        #pragma omp critical
-        {
-            inflection_vectors_map.emplace(text, inflection_vectors(range.begin(), range.end()));
-        }
+inflection_map::inflection_map(const oligo_dictionary& dictionary, const std::vector<uint32_t>& lines, const overlap_index& index)
+    : alive(dictionary.size()) {
+    for (const uint32_t line : lines) {
+        alive[line] = true;
     }
 
-    #pragma omp parallel for
-    for (auto it = potential_prefixes.begin(); it != potential_prefixes.end(); ++it) { //const std::string& text : potential_prefixes
+    fill(prefix_offsets, prefix_nodes, [&](const uint32_t node) -> const std::vector<uint32_t>& {
+        return alive[node] ? index.preceding(node) : none;
+    });
+    fill(suffix_offsets, suffix_nodes, [&](const uint32_t node) -> const std::vector<uint32_t>& {
+        return alive[node] ? index.following(node) : none;
+    });
+}
 
-        #pragma omp critical
-        {
-            inflection_vectors_map.emplace(*it, inflection_vectors());
-        }
+inflection_map::inflection_map(const oligo_dictionary& dictionary, const std::vector<uint32_t> &potential_prefixes, const std::vector<uint32_t> &potential_suffixes, uint8_t offset)
+    : alive(dictionary.size()) {
+    const overlap_index prefix_index(dictionary, potential_prefixes, offset), suffix_index(dictionary, potential_suffixes, offset);
+    std::vector<uint8_t> suffix_role(dictionary.size()), prefix_role(dictionary.size());
+    for (const uint32_t suffix : potential_suffixes) {
+        suffix_role[suffix] = alive[suffix] = true;
+    }
+    for (const uint32_t prefix : potential_prefixes) {
+        prefix_role[prefix] = alive[prefix] = true;
     }
 
-    #pragma omp parallel for
-    for (const std::string& front : potential_suffixes) {
-        const auto prefixes_ptr = inflection_vectors_map.at(front).prefixes;
-        for (const auto& back : *prefixes_ptr) {
-            #pragma omp critical
-            {
-                inflection_vectors_map.at(back).keys.push_back(prefixes_ptr);
-                inflection_vectors_map.at(back).suffixes->push_back(front);
-                inflection_vectors_map.at(front).keys.push_back(inflection_vectors_map.at(back).suffixes);
-            }
+    fill(prefix_offsets, prefix_nodes, [&](const uint32_t node) -> const std::vector<uint32_t>& {
+        return suffix_role[node] ? prefix_index.preceding(node) : none;
+    });
+    fill(suffix_offsets, suffix_nodes, [&](const uint32_t node) -> const std::vector<uint32_t>& {
+        return prefix_role[node] ? suffix_index.following(node) : none;
+    });
+}
+
+template<typename Neighbours>
+void inflection_map::fill(std::vector<uint32_t>& offsets, std::vector<uint32_t>& targets, const Neighbours& neighbours) {
+    offsets.assign(alive.size() + 1, 0);
+
+    #pragma omp parallel
+    {
+        const tracer::scope trace("inflection_map::fill degrees");
+        #pragma omp for nowait
+        for (size_t node = 0; node < alive.size(); ++node) {
+            offsets[node + 1] = std::ranges::distance(neighbours(node));
+        }
+    }
+    std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+    targets.resize(offsets.back());
+
+    #pragma omp parallel
+    {
+        const tracer::scope trace("inflection_map::fill targets");
+        #pragma omp for nowait
+        for (size_t node = 0; node < alive.size(); ++node) {
+            std::ranges::copy(neighbours(node), targets.begin() + offsets[node]);
         }
     }
 }
 
+bool inflection_map::is_prefix(const kmer& prefix, const kmer& word, uint8_t offset) {
+    if (prefix.length() <= offset or word.length() != prefix.length()) return false;
+    return prefix.head(prefix.length() - offset) == word.tail(word.length() - offset);
+}
 
-bool inflection_map::is_prefix(const std::string &prefix, const std::string &word, uint8_t offset) {
-    if (prefix.length() <= offset or word.length() <= offset) return false;
-    return prefix.substr(0, prefix.length() - offset) == word.substr(offset, word.length() - offset);
+void inflection_map::remove(const uint32_t key) {
+    if (!alive[key]) return;
+    alive[key] = false;
+    dead_edges += prefix_offsets[key + 1] - prefix_offsets[key] + suffix_offsets[key + 1] - suffix_offsets[key];
+    compact_if_sparse();
 }
 
+void inflection_map::compact_if_sparse() {
+    // The floor of one slot per node spreads each O(N) refill over O(N) removals, even on a sparse map.
+    const size_t capacity = std::max(prefix_nodes.size() + suffix_nodes.size(), alive.size());
+    if (dead_edges == 0 or dead_edges < compaction_threshold * capacity) return;
+    const std::vector<uint32_t> old_prefix_offsets = std::move(prefix_offsets), old_prefix_nodes = std::move(prefix_nodes);
+    const std::vector<uint32_t> old_suffix_offsets = std::move(suffix_offsets), old_suffix_nodes = std::move(suffix_nodes);
+    fill(prefix_offsets, prefix_nodes, [&](const uint32_t node) { return neighbours(old_prefix_offsets, old_prefix_nodes, node); });
+    fill(suffix_offsets, suffix_nodes, [&](const uint32_t node) { return neighbours(old_suffix_offsets, old_suffix_nodes, node); });
+    dead_edges = 0;
+}
 
-void inflection_map::remove(const std::string& key) {
-    if (!inflection_vectors_map.contains(key)) return;
-    #pragma omp for
-    for (auto& vector : inflection_vectors_map.at(key).keys) {
-        std::erase(*vector, key);
+std::vector<std::vector<uint32_t>> inflection_map::unitigs() const {
+    const size_t count = alive.size();
+    std::vector<uint32_t> next(count, removed_edge), previous(count, removed_edge);
+
+    #pragma omp parallel
+    {
+        const tracer::scope trace("inflection_map::unitigs links");
+        #pragma omp for
+        for (size_t node = 0; node < count; ++node) {
+            if (!alive[node]) continue;
+            const uint32_t suffix = only(get_suffixes(node), node, removed_edge);
+            if (suffix != removed_edge and only(get_prefixes(suffix), suffix, removed_edge) == node) next[node] = suffix;
+        }
+        #pragma omp for nowait
+        for (size_t node = 0; node < count; ++node) {
+            if (next[node] != removed_edge) previous[next[node]] = node;
+        }
+    }
+
+    std::vector<uint32_t> ahead(count), lowest(count);
+    #pragma omp parallel for
+    for (size_t node = 0; node < count; ++node) {
+        ahead[node] = next[node] == removed_edge ? node : next[node];
+        lowest[node] = node;
+    }
+    jump(ahead, lowest, [](const uint32_t own, const uint32_t reached) { return std::min(own, reached); });
+    #pragma omp parallel for
+    for (size_t node = 0; node < count; ++node) {
+        if (next[ahead[node]] != removed_edge and lowest[node] == node) previous[node] = removed_edge;
+    }
+    #pragma omp parallel for
+    for (size_t node = 0; node < count; ++node) {
+        if (next[node] != removed_edge and previous[next[node]] != node) next[node] = removed_edge;
     }
-    inflection_vectors_map.erase(key);
-}
 
-auto inflection_map::operator[](const std::string &key) {
-    return inflection_vectors_map.at(key);
-}
\ No newline at end of file
+    std::vector<uint32_t> head(count), rank(count);
+    #pragma omp parallel for
+    for (size_t node = 0; node < count; ++node) {
+        head[node] = previous[node] == removed_edge ? node : previous[node];
+        rank[node] = previous[node] != removed_edge;
+    }
+    jump(head, rank, std::plus());
+
+    std::vector<uint32_t> chain_of(count, removed_edge);
+    uint32_t chains_count = 0;
+    for (size_t node = 0; node < count; ++node) {
+        if (alive[node] and previous[node] == removed_edge) chain_of[node] = chains_count++;
+    }
+    std::vector<std::vector<uint32_t>> chains(chains_count);
+    #pragma omp parallel for
+    for (size_t node = 0; node < count; ++node) {
+        if (alive[node] and next[node] == removed_edge) chains[chain_of[head[node]]].resize(rank[node] + 1);
+    }
+    #pragma omp parallel for
+    for (size_t node = 0; node < count; ++node) {
+        if (alive[node]) chains[chain_of[head[node]]][rank[node]] = node;
+    }
+    return chains;
+}
@@ -1,45 +1,52 @@
 #ifndef INFLECTION_MAP_HPP
 #define INFLECTION_MAP_HPP
 
-#include <iostream>
-#include <map>
-#include <memory>
+#include <cstdint>
+#include <ranges>
+#include <span>
 #include <vector>
+#include "kmer.hpp"
+#include "oligo_dictionary.hpp"
+#include "overlap_index.hpp"
 
 class inflection_map {
 
-    struct inflection_vectors {
-        std::shared_ptr<std::vector<std::string>> prefixes, suffixes;
-        std::vector<std::shared_ptr<std::vector<std::string>>> keys;
+    static constexpr uint32_t removed_edge = UINT32_MAX;
+    static constexpr double compaction_threshold = 0.5;
 
-        inflection_vectors(const auto& begin, const auto& end);
+    std::vector<uint32_t> prefix_offsets, prefix_nodes, suffix_offsets, suffix_nodes;
+    std::vector<uint8_t> alive;
+    size_t dead_edges = 0;
 
-        inflection_vectors();
-    };
+    template<typename Neighbours>
+    void fill(std::vector<uint32_t>& offsets, std::vector<uint32_t>& targets, const Neighbours& neighbours);
 
-    std::map<std::string, inflection_vectors> inflection_vectors_map;
+    [[nodiscard]] auto neighbours(const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& targets, const uint32_t node) const {
+        return std::span(targets).subspan(offsets[node], alive[node] ? offsets[node + 1] - offsets[node] : 0)
+            | std::views::filter([this](const uint32_t neighbour) { return alive[neighbour] != 0; });
+    }
+
+    void compact_if_sparse();
 
 public:
 
-    inflection_map(const std::vector<std::string>& lines, uint8_t offset);
+    inflection_map(const oligo_dictionary& dictionary, const std::vector<uint32_t>& lines, uint8_t offset);
 
-    inflection_map(const std::vector<std::string>& potential_prefixes, const std::vector<std::string>& potential_suffixes, uint8_t offset);
+    inflection_map(const oligo_dictionary& dictionary, const std::vector<uint32_t>& lines, const overlap_index& index);
 
-    [[nodiscard]] static bool is_prefix(const std::string& prefix, const std::string& word, uint8_t offset);
+    inflection_map(const oligo_dictionary& dictionary, const std::vector<uint32_t>& potential_prefixes, const std::vector<uint32_t>& potential_suffixes, uint8_t offset);
 
-    void remove(const std::string& key);
+    [[nodiscard]] static bool is_prefix(const kmer& prefix, const kmer& word, uint8_t offset);
 
-    auto operator[] (const std::string& key);
+    void remove(uint32_t key);
 
-    // void clear_prefixes(const std::string& key);
-    //
-    // void clear_suffixes(const std::string& key);
+    [[nodiscard]] auto get_prefixes(const uint32_t key) const { return neighbours(prefix_offsets, prefix_nodes, key); }
 
-    [[nodiscard]] std::shared_ptr<std::vector<std::string>> get_prefixes(const std::string& key) const { return inflection_vectors_map.at(key).prefixes; }
+    [[nodiscard]] auto get_suffixes(const uint32_t key) const { return neighbours(suffix_offsets, suffix_nodes, key); }
 
-    [[nodiscard]] std::shared_ptr<std::vector<std::string>> get_suffixes(const std::string& key) const { return inflection_vectors_map.at(key).suffixes; }
+    [[nodiscard]] bool contains(const uint32_t key) const { return alive[key]; }
 
-    [[nodiscard]] bool contains(const std::string & line) const { return inflection_vectors_map.contains(line); }
+    [[nodiscard]] std::vector<std::vector<uint32_t>> unitigs() const;
 };
 
 
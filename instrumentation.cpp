@@ -0,0 +1,117 @@
+#include <algorithm>
+#include "instrumentation.hpp"
+#include "tracer.hpp"
+
+instrumentation::scoped_timer::scoped_timer(instrumentation* owner, const std::string_view name, const int offset)
+    : owner(owner), name(name), offset(offset), traced(tracer::enabled()), counted(owner and hardware_counters::opened()) {
+    if (owner or traced) start = std::chrono::steady_clock::now();
+    if (counted) start_counts = hardware_counters::read();
+}
+
+void instrumentation::scoped_timer::stop() {
+    if (!owner and !traced) return;
+    const auto end = std::chrono::steady_clock::now();
+    if (owner) add(owner->timings, name, offset, std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    if (traced) tracer::record(name, start, end, offset);
+    if (counted) {
+        const hardware_counters::values end_counts = hardware_counters::read();
+        for (uint8_t counter = 0; counter < hardware_counters::event_count; ++counter) {
+            if (!hardware_counters::available(static_cast<hardware_counters::event>(counter))) continue;
+            const uint64_t delta = end_counts[counter] > start_counts[counter] ? end_counts[counter] - start_counts[counter] : 0;
+            add(owner->hardware[counter], name, offset, delta);
+        }
+        add(owner->passes, name, offset, 1);
+    }
+    owner = nullptr;
+    traced = false;
+    counted = false;
+}
+
+void instrumentation::add(std::vector<entry>& entries, const std::string_view name, const int offset, const uint64_t value) {
+    const auto it = std::find_if(entries.begin(), entries.end(), [&](const entry& existing) {
+        return existing.name == name and existing.offset == offset;
+    });
+    if (it == entries.end()) entries.push_back({name, offset, value});
+    else it->value += value;
+}
+
+void instrumentation::merge(const instrumentation& other) {
+    enabled = enabled or other.enabled;
+    for (const auto& [name, offset, value] : other.timings) add(timings, name, offset, value);
+    for (const auto& [name, offset, value] : other.counters) add(counters, name, offset, value);
+    for (uint8_t counter = 0; counter < hardware_counters::event_count; ++counter) {
+        for (const auto& [name, offset, value] : other.hardware[counter]) add(hardware[counter], name, offset, value);
+    }
+    for (const auto& [name, offset, value] : other.passes) add(passes, name, offset, value);
+}
+
+void instrumentation::write(std::string& json, const std::vector<entry>& entries) {
+    std::vector<entry> sorted = entries;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const entry& a, const entry& b) {
+        return a.name == b.name ? a.offset < b.offset : a.name < b.name;
+    });
+    json += '{';
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const entry& current = sorted[i];
+        const bool opens = i == 0 or sorted[i - 1].name != current.name;
+        const bool closes = i + 1 == sorted.size() or sorted[i + 1].name != current.name;
+        if (opens) {
+            if (i > 0) json += ',';
+            json += '"' + std::string(current.name) + "\":";
+            if (current.offset != no_offset) json += '{';
+        }
+        else {
+            json += ',';
+        }
+        if (current.offset != no_offset) json += '"' + std::to_string(current.offset) + "\":";
+        json += std::to_string(current.value);
+        if (closes and current.offset != no_offset) json += '}';
+    }
+    json += '}';
+}
+
+std::string instrumentation::to_json() const {
+    std::string json = "{\"timings_us\":";
+    write(json, timings);
+    json += ",\"counters\":";
+    write(json, counters);
+    if (hardware_counters::opened()) {
+        json += ",\"hardware\":{";
+        for (uint8_t counter = 0; counter < hardware_counters::event_count; ++counter) {
+            if (counter > 0) json += ',';
+            json += '"' + std::string(hardware_counters::names[counter]) + "\":";
+            write(json, hardware[counter]);
+        }
+        json += '}';
+    }
+    json += '}';
+    return json;
+}
+
+void instrumentation::report_hardware(std::ostream& output) const {
+    if (!hardware_counters::opened()) return;
+    uint64_t oligos = 0;
+    for (const auto& [name, offset, value] : counters) {
+        if (name == "oligos") oligos += value;
+    }
+    const auto value_of = [](const std::vector<entry>& entries, const entry& phase) -> double {
+        for (const auto& [name, offset, value] : entries) {
+            if (name == phase.name and offset == phase.offset) return static_cast<double>(value);
+        }
+        return 0;
+    };
+    for (const entry& phase : timings) {
+        // Solve phases run once per iteration and read once per instance, so normalise by both.
+        const double processed = static_cast<double>(oligos) * value_of(passes, phase);
+        const auto per_oligo = [&](const hardware_counters::event counter) {
+            return processed == 0 ? 0 : value_of(hardware[counter], phase) / processed;
+        };
+        const double cycles = value_of(hardware[hardware_counters::cycles], phase);
+        output << "  " << phase.name;
+        if (phase.offset != no_offset) output << '[' << phase.offset << ']';
+        output << ": IPC " << (cycles == 0 ? 0 : value_of(hardware[hardware_counters::instructions], phase) / cycles)
+            << ", L1D/oligo " << per_oligo(hardware_counters::l1d_misses)
+            << ", LLC/oligo " << per_oligo(hardware_counters::llc_misses)
+            << ", branch/oligo " << per_oligo(hardware_counters::branch_misses) << std::endl;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "hardware_counters.hpp"
+
+class instrumentation {
+
+    struct entry {
+        std::string_view name;
+        int offset;
+        uint64_t value;
+    };
+
+    bool enabled;
+    std::vector<entry> timings, counters;
+    std::array<std::vector<entry>, hardware_counters::event_count> hardware;
+    std::vector<entry> passes;
+
+    static void add(std::vector<entry>& entries, std::string_view name, int offset, uint64_t value);
+
+    static void write(std::string& json, const std::vector<entry>& entries);
+
+public:
+
+    static constexpr int no_offset = -1;
+
+    class scoped_timer {
+
+        instrumentation* owner;
+        std::string_view name;
+        int offset;
+        bool traced;
+        bool counted;
+        std::chrono::steady_clock::time_point start;
+        hardware_counters::values start_counts;
+
+    public:
+
+        scoped_timer(instrumentation* owner, std::string_view name, int offset);
+
+        scoped_timer(const scoped_timer&) = delete;
+
+        scoped_timer& operator=(const scoped_timer&) = delete;
+
+        ~scoped_timer() { stop(); }
+
+        void stop();
+    };
+
+    explicit instrumentation(bool enabled = false) : enabled(enabled) {}
+
+    [[nodiscard]] scoped_timer time(const std::string_view name, const int offset = no_offset) {
+        return {enabled ? this : nullptr, name, offset};
+    }
+
+    void count(const std::string_view name, const uint64_t amount = 1, const int offset = no_offset) {
+        if (enabled) add(counters, name, offset, amount);
+    }
+
+    void merge(const instrumentation& other);
+
+    [[nodiscard]] std::string to_json() const;
+
+    void report_hardware(std::ostream& output) const;
+};
+
+#endif //INSTRUMENTATION_HPP
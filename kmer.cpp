@@ -0,0 +1,40 @@
+#include <stdexcept>
+#include "kmer.hpp"
+
+kmer::kmer(const std::string_view text) : bits(0) {
+    if (text.length() > max_length) {
+        throw std::invalid_argument("Oligo " + std::string(text) + " is longer than " + std::to_string(max_length) + " nucleotides\n");
+    }
+    uint64_t code = 0;
+    for (const char nucleotide : text) {
+        code <<= 2;
+        switch (nucleotide) {
+            case 'A': break;
+            case 'C': code |= 1; break;
+            case 'G': code |= 2; break;
+            case 'T': code |= 3; break;
+            default: throw std::invalid_argument("Invalid nucleotide in oligo " + std::string(text) + "\n");
+        }
+    }
+    bits = static_cast<uint64_t>(text.length()) << length_shift | code;
+}
+
+std::string kmer::to_string() const {
+    static constexpr char nucleotides[] = {'A', 'C', 'G', 'T'};
+    std::string text(length(), 'A');
+    uint64_t code = this->code();
+    for (auto it = text.rbegin(); it != text.rend(); ++it) {
+        *it = nucleotides[code & 3];
+        code >>= 2;
+    }
+    return text;
+}
+
+kmer kmer::reversed() const {
+    uint64_t code = this->code(), reversed_code = 0;
+    for (uint8_t i = 0; i < length(); ++i) {
+        reversed_code = reversed_code << 2 | (code & 3);
+        code >>= 2;
+    }
+    return {reversed_code, length()};
+}
@@ -0,0 +1,54 @@
+#ifndef KMER_HPP
+#define KMER_HPP
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+class kmer {
+
+    static constexpr uint8_t length_shift = 58;
+
+    uint64_t bits;
+
+    kmer(uint64_t code, uint8_t length) : bits(static_cast<uint64_t>(length) << length_shift | code) {}
+
+    [[nodiscard]] static uint64_t mask(uint8_t count) { return (uint64_t{1} << 2 * count) - 1; }
+
+public:
+
+    static constexpr uint8_t max_length = length_shift / 2;
+
+    kmer() : bits(0) {}
+
+    explicit kmer(std::string_view text);
+
+    [[nodiscard]] kmer head(uint8_t count) const { return {code() >> 2 * (length() - count), count}; }
+
+    [[nodiscard]] kmer tail(uint8_t count) const { return {code() & mask(count), count}; }
+
+    [[nodiscard]] kmer padded(uint8_t count) const { return {code() << 2 * (count - length()), count}; }
+
+    [[nodiscard]] kmer reversed() const;
+
+    [[nodiscard]] std::string to_string() const;
+
+    [[nodiscard]] uint64_t code() const { return bits & mask(max_length); }
+
+    [[nodiscard]] uint8_t length() const { return bits >> length_shift; }
+
+    [[nodiscard]] uint64_t value() const { return bits; }
+
+    [[nodiscard]] bool operator==(const kmer& other) const = default;
+
+    [[nodiscard]] auto operator<=>(const kmer& other) const = default;
+};
+
+template<>
+struct std::hash<kmer> {
+    size_t operator()(const kmer& key) const noexcept { return std::hash<uint64_t>{}(key.value()); }
+};
+
+#endif //KMER_HPP
@@ -1,97 +1,332 @@
-#include <fstream>
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include "chunked_reader.hpp"
+#include "end_index.hpp"
+#include "hardware_counters.hpp"
 #include "inflection_map.hpp"
+#include "instrumentation.hpp"
+#include "kmer.hpp"
+#include "mapped_file.hpp"
+#include "oligo_dictionary.hpp"
+#include "overlap_index.hpp"
 #include "sequence_vector.hpp"
+#include "tracer.hpp"
 #include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <omp.h>
 
-std::vector<std::string> read_lines(const std::string& filename = "10.500-100.txt") {
-    std::ifstream input_file(filename);
-    std::vector<std::string> lines;
-    if (input_file) {
-        std::string line_buffer;
-        while (std::getline(input_file, line_buffer)) lines.push_back(line_buffer);
-    }
-    else {
-        throw std::runtime_error("Cannot open " + filename + "\n");
+std::vector<uint32_t> read_lines(oligo_dictionary& dictionary, const std::string& filename = "10.500-100.txt") {
+    const mapped_file input_file(filename);
+    std::string_view text = input_file.view();
+    std::vector<uint32_t> lines;
+    while (!text.empty()) {
+        const size_t end = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, end);
+        if (line.ends_with('\r')) line.remove_suffix(1);
+        lines.push_back(dictionary.intern(kmer(line)));
+        text.remove_prefix(std::min(end + 1, text.size()));
     }
     return lines;
 }
 
+struct options {
+    bool batch = false;
+    bool streamed = false;
+    bool unitigs = false;
+    bool greedy = false;
+    bool parallel_merge = false;
+    std::string stats_path;
+    std::string trace_path;
+    bool perf = false;
+
+    [[nodiscard]] bool instrumented() const { return !stats_path.empty() or perf; }
+};
+
+// The overlap index is built once per instance, outside the per-iteration solve time,
+// so its build time is kept here and reported next to it. Streamed loads interleave
+// reading with indexing, so for them it covers the whole load.
+struct instance {
+    oligo_dictionary dictionary;
+    std::vector<uint32_t> words;
+    std::chrono::microseconds indexing {};
+    overlap_index overlaps;
+
+    instance(const std::string& filename, const bool streamed)
+        : words(streamed ? std::vector<uint32_t>() : read_lines(dictionary, filename)),
+          overlaps(streamed ? overlap_index(dictionary, 1) : timed_index()) {
+        if (!streamed) return;
+        const auto start = std::chrono::high_resolution_clock::now();
+        chunked_reader(filename).for_each_line([this](const std::string_view line) {
+            const uint32_t word = dictionary.intern(kmer(line));
+            words.push_back(word);
+            overlaps.insert(word);
+        });
+        indexing = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+    }
+
+    overlap_index timed_index() {
+        const auto start = std::chrono::high_resolution_clock::now();
+        overlap_index index(dictionary, words, 1);
+        indexing = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+        return index;
+    }
+
+    instance(const instance&) = delete;
+    instance& operator=(const instance&) = delete;
+};
+
 struct measurements {
     unsigned int skipped_count;
     std::chrono::microseconds duration;
     int count;
 };
 
-void process_file(const std::string& filename, unsigned int origin_sequence_length, int l = 10) {
-    std::map<std::string,measurements> results;
-    for(auto iteration = 0; iteration < l; ++iteration) {
-        std::vector<std::string> words = read_lines(filename);
-        auto start = std::chrono::high_resolution_clock::now();
-        sequence_vector sequences(words, origin_sequence_length);
-
-        for(int offset = 2; offset < 10 and sequences.size() > 1; ++offset) {
-            sequences.sort();
-            if(sequences.get_first_length() >= origin_sequence_length) {
-                break;
-            }
-            inflection_map map(sequences.backs(),sequences.fronts(), offset);
-            sequences.merge(map, offset);
-        }
+struct solution {
+    std::string result;
+    unsigned int skipped_count;
+    std::chrono::microseconds duration;
+    instrumentation stats;
+};
+
+solution solve(const instance& spectrum, const options& settings, unsigned int origin_sequence_length) {
+    const oligo_dictionary& dictionary = spectrum.dictionary;
+    instrumentation stats(settings.instrumented());
+    auto start = std::chrono::high_resolution_clock::now();
+    auto construction = stats.time("construct");
+    sequence_vector sequences = settings.unitigs
+        ? sequence_vector(dictionary, inflection_map(dictionary, spectrum.words, spectrum.overlaps).unitigs(), origin_sequence_length)
+        : sequence_vector(dictionary, spectrum.words, spectrum.overlaps, origin_sequence_length);
+    construction.stop();
+    sequences.instrument(stats);
+    stats.count("removed", sequences.get_removed_count(), 1);
+    auto indexing = stats.time("ends");
+    end_index ends(dictionary, sequences.fronts(), sequences.backs());
+    indexing.stop();
 
-        std::string result = sequences.get_first();
-        if(result.length() > origin_sequence_length) {
-            result = result.substr(0, origin_sequence_length);
+    if (settings.greedy) {
+        auto assembly = stats.time("assemble");
+        sequences.assemble(ends, 10);
+    }
+    for(int offset = sequences.next_offset(ends, settings.unitigs ? 1 : 2); !settings.greedy and offset < 10 and sequences.size() > 1; offset = sequences.next_offset(ends, offset + 1)) {
+        if(sequences.get_first_length() >= origin_sequence_length) {
+            break;
         }
-        auto end = std::chrono::high_resolution_clock::now();
-        if (results.contains(result)) {
-            results[result].count++;
-            results[result].duration += std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        auto merging = stats.time("merge", offset);
+        if (settings.parallel_merge) {
+            sequences.merge_parallel(ends, offset);
         }
         else {
-            results.emplace(result, measurements{
-                                sequences.get_first_skipped_count(origin_sequence_length),
-                                std::chrono::duration_cast<std::chrono::microseconds>(end - start),
-                                1
-                            });
+            sequences.merge(ends, offset);
         }
     }
+
+    auto finishing = stats.time("result");
+    std::string result = sequences.get_first();
+    if(result.length() > origin_sequence_length) {
+        result = result.substr(0, origin_sequence_length);
+    }
+    finishing.stop();
+    auto end = std::chrono::high_resolution_clock::now();
+    return {result, sequences.get_first_skipped_count(origin_sequence_length), std::chrono::duration_cast<std::chrono::microseconds>(end - start), stats};
+}
+
+void record(std::map<std::string,measurements>& results, const solution& solved) {
+    if (results.contains(solved.result)) {
+        results[solved.result].count++;
+        results[solved.result].duration += solved.duration;
+    }
+    else {
+        results.emplace(solved.result, measurements{solved.skipped_count, solved.duration, 1});
+    }
+}
+
+void print_results(const std::map<std::string,measurements>& results, unsigned int origin_sequence_length, int l, std::chrono::microseconds indexing) {
     std::cout << "liczba znalezionych rozwiązań : " << results.size() << '\t'
     << "rozwiązania: " << std::endl;
+    std::cout << "Indeks nakładek, raz na instancję (mikrosekundy): " << indexing.count() << std::endl;
     for(const auto &[sequence, measurement] : results) {
         double accuracy = origin_sequence_length - measurement.skipped_count - l + 1;
         accuracy /= origin_sequence_length - l + 1;
         std::cout<< "Czas(mikrosekundy): " << measurement.duration.count() / measurement.count << '\t' << "\t jakość:" << accuracy << std::endl;
     }
+}
 
+void write_stats(const options& settings, const std::string& filename, int l, const instrumentation& stats) {
+    if (settings.stats_path.empty()) return;
+    std::string name;
+    for (const char c : filename) {
+        if (c == '"' or c == '\\') name += '\\';
+        name += c;
+    }
+    std::ofstream(settings.stats_path, std::ios::app) << "{\"instance\":\"" << name << "\",\"iterations\":" << l << ",\"stats\":" << stats.to_json() << "}\n";
 }
 
-int main() {
+void process_file(const std::string& filename, const options& settings, unsigned int origin_sequence_length, int l = 10) {
+    std::map<std::string,measurements> results;
+    instrumentation stats(settings.instrumented());
+    auto reading = stats.time("read");
+    const instance spectrum(filename, settings.streamed);
+    reading.stop();
+    stats.count("oligos", spectrum.words.size());
+    for(auto iteration = 0; iteration < l; ++iteration) {
+        const solution solved = solve(spectrum, settings, origin_sequence_length);
+        record(results, solved);
+        stats.merge(solved.stats);
+    }
+    print_results(results, origin_sequence_length, l, spectrum.indexing);
+    stats.report_hardware(std::cout);
+    write_stats(settings, filename, l, stats);
+}
 
-    for (const auto& entry : std::filesystem::directory_iterator("instancje_z_bledami_negatywnymi_wynikajacymi_z_powtorzen")) {
-        if (!entry.is_regular_file()) continue;
-        process_file(entry.path(), 500, 10);
+unsigned int origin_length_of(const std::string& filename, const unsigned int fallback = 500) {
+    const std::string name = std::filesystem::path(filename).stem();
+    const size_t first = name.find('.'), last = name.find_first_of("+-", first);
+    if (first == std::string::npos or last == std::string::npos or last == first + 1) return fallback;
+    const std::string digits = name.substr(first + 1, last - first - 1);
+    if (!std::ranges::all_of(digits, [](const char c) { return c >= '0' and c <= '9'; })) return fallback;
+    return std::stoul(digits);
+}
+
+std::vector<std::map<std::string,measurements>> process_batch(const std::vector<std::string>& filenames, const options& settings, std::vector<instrumentation>& stats, std::vector<std::chrono::microseconds>& indexing, int l = 10) {
+    std::vector<std::vector<solution>> solutions(filenames.size(), std::vector<solution>(l));
+    stats.assign(filenames.size(), instrumentation(settings.instrumented()));
+    indexing.assign(filenames.size(), {});
+    const int max_active_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(1);
+
+    #pragma omp parallel
+    #pragma omp single
+    for (size_t file = 0; file < filenames.size(); ++file) {
+        #pragma omp task firstprivate(file) shared(solutions, filenames, settings, stats, indexing)
+        {
+            auto reading = stats[file].time("read");
+            const instance spectrum(filenames[file], settings.streamed);
+            reading.stop();
+            stats[file].count("oligos", spectrum.words.size());
+            indexing[file] = spectrum.indexing;
+            for (int iteration = 0; iteration < l; ++iteration) {
+                #pragma omp task firstprivate(file, iteration) shared(solutions, spectrum, filenames, settings)
+                solutions[file][iteration] = solve(spectrum, settings, origin_length_of(filenames[file]));
+            }
+            // The instance lives only until this file's iterations finish.
+            #pragma omp taskwait
+        }
     }
-    std::cout << std::endl;
-    for (const auto& entry : std::filesystem::directory_iterator("instancje_z_bloedami_negatywnymi_losowymi")) {
-        if (!entry.is_regular_file()) continue;
-        process_file(entry.path(), 500, 10);
+
+    omp_set_max_active_levels(max_active_levels);
+    std::vector<std::map<std::string,measurements>> results(filenames.size());
+    for (size_t file = 0; file < filenames.size(); ++file) {
+        for (const auto& solved : solutions[file]) {
+            record(results[file], solved);
+            stats[file].merge(solved.stats);
+        }
     }
-    std::cout << std::endl;
-    for (const auto& entry : std::filesystem::directory_iterator("pozytywne_przeklamania_na_koncach_oligo")) {
+    return results;
+}
+
+std::vector<std::string> list_instances(const std::string& directory) {
+    std::vector<std::string> filenames;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
         if (!entry.is_regular_file()) continue;
-        process_file(entry.path(), 500, 10);
+        filenames.push_back(entry.path());
     }
-    std::cout << std::endl;
-    for (const auto& entry : std::filesystem::directory_iterator("pozytywne_losowe")) {
-        if (!entry.is_regular_file()) continue;
-        process_file(entry.path(), 500, 10);
+    return filenames;
+}
+
+void print_usage(const char* program) {
+    std::cout << "użycie: " << program << " [opcje] [katalog...]\n"
+        << "  --batch           rozwiązuje wszystkie pliki naraz jako zadania OpenMP\n"
+        << "  --stream          wczytuje instancje porcjami prosto do indeksu nakładek\n"
+        << "  --unitigs         buduje początkowe łańcuchy równolegle jako unitigi\n"
+        << "  --greedy          eksperymentalne: zachłanne łączenie z kolejki priorytetowej;\n"
+        << "                    daje niższą jakość niż domyślna pętla po przesunięciach\n"
+        << "  --parallel-merge  łączy sekwencje rundami z równoległym wyborem par\n"
+        << "  --stats=<plik>    zapisuje czasy i liczniki faz jako JSON\n"
+        << "  --trace=<plik>    zapisuje aktywność wątków w formacie Chrome trace\n"
+        << "  --perf            zbiera sprzętowe liczniki wydajności dla każdej fazy\n"
+        << "  --help            wyświetla tę pomoc" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    options settings;
+    std::vector<std::string> directories;
+    for (int argument = 1; argument < argc; ++argument) {
+        const std::string flag = argv[argument];
+        if (flag == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (flag == "--batch") settings.batch = true;
+        else if (flag == "--stream") settings.streamed = true;
+        else if (flag == "--unitigs") settings.unitigs = true;
+        else if (flag == "--greedy") settings.greedy = true;
+        else if (flag == "--parallel-merge") settings.parallel_merge = true;
+        else if (flag.starts_with("--stats=")) settings.stats_path = flag.substr(8);
+        else if (flag == "--perf") settings.perf = true;
+        else if (flag.starts_with("--trace=")) settings.trace_path = flag.substr(8);
+        else if (!flag.starts_with("--")) directories.push_back(flag);
+        else throw std::invalid_argument("Nieznana opcja: " + flag);
+    }
+    if (directories.empty()) {
+        directories = {
+            "instancje_z_bledami_negatywnymi_wynikajacymi_z_powtorzen",
+            "instancje_z_bloedami_negatywnymi_losowymi",
+            "pozytywne_przeklamania_na_koncach_oligo",
+            "pozytywne_losowe"
+        };
+    }
+
+    std::vector<std::vector<std::string>> instances;
+    std::vector<std::string> filenames;
+    for (const auto& directory : directories) {
+        instances.push_back(list_instances(directory));
+        filenames.insert(filenames.end(), instances.back().begin(), instances.back().end());
+    }
+
+    if (!settings.stats_path.empty()) {
+        std::ofstream(settings.stats_path, std::ios::trunc);
+    }
+    if (!settings.trace_path.empty()) {
+        tracer::enable();
+    }
+    if (settings.perf) {
+        try {
+            hardware_counters::open();
+        }
+        catch (const std::runtime_error& error) {
+            std::cerr << "Uwaga: " << error.what() << "Pomiary bez liczników sprzętowych." << std::endl;
+        }
     }
 
+    std::vector<std::map<std::string,measurements>> results;
+    std::vector<instrumentation> stats;
+    std::vector<std::chrono::microseconds> indexing;
+    if (settings.batch) {
+        results = process_batch(filenames, settings, stats, indexing, 10);
+    }
+
+    size_t file = 0;
+    for (size_t directory = 0; directory < instances.size(); ++directory) {
+        if (directory > 0) std::cout << std::endl;
+        for (const auto& filename : instances[directory]) {
+            if (settings.batch) {
+                print_results(results[file], origin_length_of(filename), 10, indexing[file]);
+                stats[file].report_hardware(std::cout);
+                write_stats(settings, filename, 10, stats[file++]);
+            }
+            else {
+                process_file(filename, settings, origin_length_of(filename), 10);
+            }
+        }
+    }
+
+    if (!settings.trace_path.empty()) {
+        tracer::dump(settings.trace_path);
+    }
     return 0;
 }
-
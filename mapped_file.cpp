@@ -0,0 +1,35 @@
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mapped_file.hpp"
+
+mapped_file::mapped_file(const std::string& filename) : data(nullptr), size_value(0) {
+    const int descriptor = open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Cannot open " + filename + "\n");
+    }
+    struct stat status {};
+    if (fstat(descriptor, &status) < 0) {
+        close(descriptor);
+        throw std::runtime_error("Cannot stat " + filename + "\n");
+    }
+    size_value = status.st_size;
+    if (size_value > 0) {
+        void* mapping = mmap(nullptr, size_value, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error("Cannot map " + filename + "\n");
+        }
+        madvise(mapping, size_value, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapping);
+    }
+    close(descriptor);
+}
+
+mapped_file::~mapped_file() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), size_value);
+    }
+}
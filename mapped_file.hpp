@@ -0,0 +1,25 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+
+class mapped_file {
+
+    const char* data;
+    size_t size_value;
+
+public:
+
+    explicit mapped_file(const std::string& filename);
+
+    mapped_file(const mapped_file&) = delete;
+
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file();
+
+    [[nodiscard]] std::string_view view() const { return {data, size_value}; }
+};
+
+#endif //MAPPED_FILE_HPP
@@ -0,0 +1,9 @@
+#include "oligo_dictionary.hpp"
+
+uint32_t oligo_dictionary::intern(const kmer& oligo) {
+    const auto [it, inserted] = ids.try_emplace(oligo, oligos.size());
+    if (inserted) {
+        oligos.push_back(oligo);
+    }
+    return it->second;
+}
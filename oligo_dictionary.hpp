@@ -0,0 +1,23 @@
+#ifndef OLIGO_DICTIONARY_HPP
+#define OLIGO_DICTIONARY_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "kmer.hpp"
+
+class oligo_dictionary {
+
+    std::vector<kmer> oligos;
+    std::unordered_map<kmer, uint32_t> ids;
+
+public:
+
+    uint32_t intern(const kmer& oligo);
+
+    [[nodiscard]] const kmer& operator[](const uint32_t id) const { return oligos[id]; }
+
+    [[nodiscard]] size_t size() const { return oligos.size(); }
+};
+
+#endif //OLIGO_DICTIONARY_HPP
@@ -0,0 +1,44 @@
+#include "overlap_index.hpp"
+#include "sharding.hpp"
+#include "tracer.hpp"
+
+overlap_index::overlap_index(const oligo_dictionary& dictionary, const uint8_t offset)
+    : dictionary(dictionary), words_by_tail(shard_count), words_by_head(shard_count), offset(offset) {}
+
+overlap_index::overlap_index(const oligo_dictionary& dictionary, const std::vector<uint32_t>& words, const uint8_t offset)
+    : dictionary(dictionary), words_by_tail(shard_count), words_by_head(shard_count), offset(offset) {
+
+    const auto tails = partition_by_shard(words.size(), [&](const size_t i) { return shard_of(tail_window(dictionary[words[i]])); });
+    const auto heads = partition_by_shard(words.size(), [&](const size_t i) { return shard_of(head_window(dictionary[words[i]])); });
+
+    #pragma omp parallel
+    {
+        const tracer::scope trace("overlap_index::build");
+        #pragma omp for schedule(dynamic) nowait
+        for (size_t shard = 0; shard < shard_count; ++shard) {
+            for (const size_t i : tails[shard]) {
+                const kmer& word = dictionary[words[i]];
+                if (word.length() > offset) words_by_tail[shard][tail_window(word)].push_back(words[i]);
+            }
+            for (const size_t i : heads[shard]) {
+                const kmer& word = dictionary[words[i]];
+                if (word.length() > offset) words_by_head[shard][head_window(word)].push_back(words[i]);
+            }
+        }
+    }
+}
+
+void overlap_index::insert(const uint32_t word) {
+    const kmer& oligo = dictionary[word];
+    if (oligo.length() <= offset) return;
+    const kmer tail = tail_window(oligo), head = head_window(oligo);
+    words_by_tail[shard_of(tail)][tail].push_back(word);
+    words_by_head[shard_of(head)][head].push_back(word);
+}
+
+const std::vector<uint32_t>& overlap_index::find(const std::vector<shard>& shards, const kmer& window) {
+    static const std::vector<uint32_t> none;
+    const auto& words = shards[shard_of(window)];
+    const auto it = words.find(window);
+    return it == words.end() ? none : it->second;
+}
@@ -0,0 +1,36 @@
+#ifndef OVERLAP_INDEX_HPP
+#define OVERLAP_INDEX_HPP
+
+#include <unordered_map>
+#include <vector>
+#include "kmer.hpp"
+#include "oligo_dictionary.hpp"
+
+class overlap_index {
+
+    using shard = std::unordered_map<kmer, std::vector<uint32_t>>;
+
+    const oligo_dictionary& dictionary;
+    std::vector<shard> words_by_tail, words_by_head;
+    uint8_t offset;
+
+    [[nodiscard]] kmer head_window(const kmer& word) const { return word.length() > offset ? word.head(word.length() - offset) : kmer(); }
+
+    [[nodiscard]] kmer tail_window(const kmer& word) const { return word.length() > offset ? word.tail(word.length() - offset) : kmer(); }
+
+    [[nodiscard]] static const std::vector<uint32_t>& find(const std::vector<shard>& shards, const kmer& window);
+
+public:
+
+    overlap_index(const oligo_dictionary& dictionary, uint8_t offset);
+
+    overlap_index(const oligo_dictionary& dictionary, const std::vector<uint32_t>& words, uint8_t offset);
+
+    void insert(uint32_t word);
+
+    [[nodiscard]] const std::vector<uint32_t>& preceding(const uint32_t text) const { return find(words_by_tail, head_window(dictionary[text])); }
+
+    [[nodiscard]] const std::vector<uint32_t>& following(const uint32_t text) const { return find(words_by_head, tail_window(dictionary[text])); }
+};
+
+#endif //OVERLAP_INDEX_HPP
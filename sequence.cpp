@@ -1,39 +1,45 @@
+#include <algorithm>
 #include "sequence.hpp"
 
-sequence::sequence(const std::string& text) {
-    fragments = {fragment(text,0)};
-    length_value = text.length();
+sequence::sequence(const oligo_dictionary& dictionary, const uint32_t oligo) : dictionary(&dictionary) {
+    segments = {{fragment(oligo,0)}};
+    length_value = dictionary[oligo].length();
+    size_value = 1;
 }
 
-sequence::sequence(const std::string& first, const std::string& second, const int offset) {
-    fragments = {fragment(first,offset), fragment(second,0)};
-    length_value = first.length() + second.length() - offset;
+sequence::sequence(const oligo_dictionary& dictionary, const uint32_t first, const uint32_t second, const int offset) : dictionary(&dictionary) {
+    segments = {{fragment(first,offset), fragment(second,0)}};
+    length_value = dictionary[first].length() + dictionary[second].length() - offset;
+    size_value = 2;
 }
 
-void sequence::add_front(const std::string &text, const int offset) {
-    fragments.push_front(fragment(text,offset));
+void sequence::add_front(const uint32_t oligo, const int offset) {
+    segments.front().push_front(fragment(oligo,offset));
     length_value += offset;
+    ++size_value;
 }
 
-void sequence::add_back(const std::string &text, const int offset) {
-    fragments.back().offset = offset;
-    fragments.push_back(fragment(text,0));
+void sequence::add_back(const uint32_t oligo, const int offset) {
+    segments.back().back().offset = offset;
+    segments.back().push_back(fragment(oligo,0));
     length_value += offset;
+    ++size_value;
 }
 
-void sequence::join(const sequence &other, const int offset) {
-    fragments.back().offset = offset;
+void sequence::join(sequence&& other, const int offset) {
+    segments.back().back().offset = offset;
     length_value += other.length_value - offset;
-    for (const auto& fragment : other.fragments) {
-        fragments.push_back(fragment);
-    }
+    size_value += other.size_value;
+    segments.splice(segments.end(), other.segments);
+    other.size_value = 0;
+    other.length_value = 0;
 }
 
 std::string sequence::to_string() const {
-    std::string result = front();
+    std::string result = (*dictionary)[front()].to_string();
     int previous_offset = 0;
-    for (const auto&[text, offset] : fragments) {
-        result += text.substr(text.length() - previous_offset, previous_offset);
+    for (const auto&[oligo, offset] : fragments()) {
+        result += (*dictionary)[oligo].tail(previous_offset).to_string();
         previous_offset = offset;
     }
     return result;
@@ -45,20 +51,13 @@ bool sequence::operator==(const sequence &other) const {
         return false;
     }
 
-    for (auto it = fragments.begin(), other_it = other.fragments.begin();
-        it != fragments.end(); ++it, ++other_it) {
-
-        if (it->text != other_it->text) {
-            return false;
-        }
-    }
-    return true;
+    return std::ranges::equal(fragments(), other.fragments(), {}, &fragment::oligo, &fragment::oligo);
 }
 
 unsigned int sequence::get_skipped_count(unsigned int length) const {
-    unsigned int current_length = front().length();
+    unsigned int current_length = (*dictionary)[front()].length();
     unsigned int skipped = 0;
-    for (const auto& fragment : fragments) {
+    for (const auto& fragment : fragments()) {
         if (current_length >= length) { break;}
         current_length += fragment.offset;
         skipped += fragment.offset - 1;
@@ -68,4 +67,3 @@ unsigned int sequence::get_skipped_count(unsigned int length) const {
     }
     return skipped;
 }
-
@@ -1,41 +1,49 @@
 #ifndef SEQUENCE_HPP
 #define SEQUENCE_HPP
+#include <cstdint>
 #include <deque>
+#include <list>
+#include <ranges>
 #include <string>
+#include "oligo_dictionary.hpp"
 
 class sequence {
 
     struct fragment {
-        std::string text;
+        uint32_t oligo;
         int offset;
     };
 
-    std::deque<fragment> fragments;
+    const oligo_dictionary* dictionary;
+    std::list<std::deque<fragment>> segments;
     unsigned int length_value;
+    size_t size_value;
+
+    [[nodiscard]] auto fragments() const { return segments | std::views::join; }
 
     public:
 
-    explicit sequence(const std::string& text) ;
+    sequence(const oligo_dictionary& dictionary, uint32_t oligo);
 
-    sequence(const std::string& first, const std::string& second, int offset = 1);
+    sequence(const oligo_dictionary& dictionary, uint32_t first, uint32_t second, int offset = 1);
 
-    void add_front(const std::string& text, int offset);
+    void add_front(uint32_t oligo, int offset);
 
-    void add_back(const std::string& text, int offset);
+    void add_back(uint32_t oligo, int offset);
 
-    void join(const sequence& other, int offset);
+    void join(sequence&& other, int offset);
 
     [[nodiscard]] std::string to_string() const;
 
     [[nodiscard]] bool operator==(const sequence& other) const;
 
-    [[nodiscard]] std::string front() const { return fragments.front().text; }
+    [[nodiscard]] uint32_t front() const { return segments.front().front().oligo; }
 
-    [[nodiscard]] std::string back() const { return fragments.back().text; }
+    [[nodiscard]] uint32_t back() const { return segments.back().back().oligo; }
 
     [[nodiscard]] unsigned int length() const { return length_value; }
 
-    [[nodiscard]] auto size() const { return fragments.size(); }
+    [[nodiscard]] size_t size() const { return size_value; }
 
     [[nodiscard]] unsigned int get_skipped_count(unsigned int length) const;
 };
@@ -1,119 +1,312 @@
 #include <algorithm>
+#include <optional>
+#include <queue>
 #include "sequence_vector.hpp"
+#include "tracer.hpp"
 
 #include <ranges>
 
-sequence_vector::sequence_vector(std::vector<std::string>& words, uint origin_length) {
+sequence_vector::sequence_vector(const oligo_dictionary& dictionary, const std::vector<uint32_t>& words, uint origin_length)
+    : sequence_vector(dictionary, words, overlap_index(dictionary, words, 1), origin_length) {}
+
+sequence_vector::sequence_vector(const oligo_dictionary& dictionary, const std::vector<uint32_t>& words, const overlap_index& overlaps, uint origin_length)
+    : dictionary(dictionary), sequences_by_front(dictionary.size()), sequences_by_back(dictionary.size()) {
     max_sequence_length = origin_length;
-    inflection_map map(words, 1);
+    inflection_map map(dictionary, words, overlaps);
+    std::vector<bool> consumed(dictionary.size());
 
-    while(!words.empty()) {
-        const std::string word = *words.begin();
-        auto seq = std::make_shared<sequence>(word);
-        std::erase(words, word);
+    for (const uint32_t word : words) {
+        if (consumed[word]) continue;
+        sequence seq(dictionary, word);
+        consumed[word] = true;
 
-        while (!map.get_prefixes(seq->front())->empty() and seq->length() < max_sequence_length) { //while (map.contains(seq->front()) and !map.get_prefixes(seq->front())->empty())
-            const std::string prefix = *map.get_prefixes(seq->front())->begin();
-            if(seq->size() > 1) {
-                map.remove(seq->front());
+        while (!map.get_prefixes(seq.front()).empty() and seq.length() < max_sequence_length) { //while (map.contains(seq.front()) and !map.get_prefixes(seq.front()).empty())
+            const uint32_t prefix = *map.get_prefixes(seq.front()).begin();
+            if(seq.size() > 1) {
+                map.remove(seq.front());
+                ++removed_nodes;
             }
-            std::erase(words, prefix);
-            seq->add_front(prefix, 1);
+            consumed[prefix] = true;
+            seq.add_front(prefix, 1);
         }
 
-        while (!map.get_suffixes(seq->back())->empty() and seq->length() < max_sequence_length) { // while (map.contains(seq->back()) and !map.get_suffixes(seq->back())->empty())
-            const std::string suffix = *map.get_suffixes(seq->back())->begin();
-            if(seq->size() > 1) {
-                map.remove(seq->back());
+        while (!map.get_suffixes(seq.back()).empty() and seq.length() < max_sequence_length) { // while (map.contains(seq.back()) and !map.get_suffixes(seq.back()).empty())
+            const uint32_t suffix = *map.get_suffixes(seq.back()).begin();
+            if(seq.size() > 1) {
+                map.remove(seq.back());
+                ++removed_nodes;
             }
-            seq->add_back(suffix, 1);
-            std::erase(words, suffix);
+            seq.add_back(suffix, 1);
+            consumed[suffix] = true;
         }
 
-        sequences.push_back(seq);
-        sequences_by_back[seq->back()] = seq;
-        sequences_by_front[seq->front()] = seq;
-        if(seq->length() == max_sequence_length) {
+        const bool complete = seq.length() == max_sequence_length;
+        const handle key = sequences.insert(std::move(seq));
+        bind(sequences_by_back, sequences[key].back(), key);
+        bind(sequences_by_front, sequences[key].front(), key);
+        ranking.insert(rank_of(key));
+        if(complete) {
             break;
         }
     }
+    components = disjoint_set(sequences.size());
 }
 
-void sequence_vector::sort() {
-    std::sort(sequences.begin(),sequences.end(), [](const std::shared_ptr<sequence> a,const std::shared_ptr<sequence> b) {
-        return a->length() == b->length() ? a->size() < b->size() : a->length() > b->length();
-    });
+sequence_vector::sequence_vector(const oligo_dictionary& dictionary, const std::vector<std::vector<uint32_t>>& chains, uint origin_length)
+    : dictionary(dictionary), sequences_by_front(dictionary.size()), sequences_by_back(dictionary.size()) {
+    max_sequence_length = origin_length;
+    std::vector<std::optional<sequence>> built(chains.size());
+
+    #pragma omp parallel
+    {
+        const tracer::scope trace("sequence_vector::chains");
+        #pragma omp for schedule(dynamic) nowait
+        for (size_t chain = 0; chain < chains.size(); ++chain) {
+            built[chain].emplace(dictionary, chains[chain].front());
+            for (const uint32_t oligo : chains[chain] | std::views::drop(1)) {
+                built[chain]->add_back(oligo, 1);
+            }
+        }
+    }
+
+    sequences.reserve(built.size());
+    for (auto& seq : built) {
+        const handle key = sequences.insert(std::move(*seq));
+        bind(sequences_by_back, sequences[key].back(), key);
+        bind(sequences_by_front, sequences[key].front(), key);
+        ranking.insert(rank_of(key));
+    }
+    components = disjoint_set(sequences.size());
 }
 
-void sequence_vector::merge(const std::shared_ptr<sequence>& merge_to, const std::shared_ptr<sequence>& merged, inflection_map& map, int offset) {
-    if(merge_to == merged) {
+std::vector<sequence_vector::handle> sequence_vector::ordered() const {
+    std::vector<handle> keys;
+    keys.reserve(ranking.size());
+    for (const ranked& entry : ranking) {
+        keys.push_back(entry.key);
+    }
+    return keys;
+}
+
+void sequence_vector::merge(const handle merge_to, const handle merged, end_index& ends, int offset) {
+    if(!components.unite(merge_to.index, merged.index)) {
+        count("rejected", offset);
         return;
     }
-    map.remove(merge_to->back());
-    map.remove(merged->front());
+    count("merges", offset);
+    ranking.erase(rank_of(merge_to));
+    ranking.erase(rank_of(merged));
 
-    sequences_by_back[merged->back()] = sequences_by_back[merge_to->back()];
-    sequences_by_back.erase(merge_to->back());
-    sequences_by_front.erase(merged->front());
-    merge_to->join(*merged, offset);
+    if (auto& slot = sequences_by_back[sequences[merge_to].back()]; slot.present and slot.owner == merge_to) {
+        slot.present = false;
+        ends.erase_back(sequences[merge_to].back());
+    }
+    if (auto& slot = sequences_by_front[sequences[merged].front()]; slot.present and slot.owner == merged) {
+        slot.present = false;
+        ends.erase_front(sequences[merged].front());
+    }
+    const uint32_t back = sequences[merged].back();
+    ends.insert_back(back);
+    sequences[merge_to].join(std::move(sequences[merged]), offset);
+    bind(sequences_by_back, back, merge_to);
+    ranking.insert(rank_of(merge_to));
+    if (auto& slot = sequences_by_front[sequences[merge_to].front()]; slot.present and slot.owner == merge_to) {
+        slot.length = sequences[merge_to].length();
+    }
 
-    std::erase(sequences, merged);
+    sequences.erase(merged);
 }
 
-void sequence_vector::merge(inflection_map& map, const int offset) {
-    for (size_t i = 0; i < sequences.size(); ++i) {
+void sequence_vector::merge(end_index& ends, const int offset) {
+    bool complete = false;
+    for (handle seq : ordered()) {
+        if (complete) break;
+        if (!sequences.contains(seq)) continue;
 
-        std::shared_ptr<sequence> seq = sequences[i];
-
-        while (map.contains(seq->back()) and !map.get_suffixes(seq->back())->empty()) {
-            auto suffixes = map.get_suffixes(seq->back());
-            std::string suffix = *std::max_element(suffixes->begin(), suffixes->end(),
-                [this](const std::string& a, const std::string& b) {
-                    return get_by_front(a)->length() < get_by_front(b)->length();
+        while (!suffixes_of(ends, seq, offset).empty()) {
+            auto suffixes = suffixes_of(ends, seq, offset);
+            uint32_t suffix = *std::max_element(suffixes.begin(), suffixes.end(),
+                [this](const uint32_t a, const uint32_t b) {
+                    const unsigned int a_length = sequences_by_front[a].length, b_length = sequences_by_front[b].length;
+                    return a_length == b_length ? a > b : a_length < b_length;
                 }
             );
-            auto other_seq = get_by_front(suffix);
-            if(seq == other_seq) {
-                std::erase(*suffixes,suffix);
-                std::erase(*map.get_prefixes(suffix), seq->back());
+            merge(seq, get_by_front(suffix), ends, offset);
+            complete = complete or sequences[seq].length() >= max_sequence_length;
+        }
+
+        while (!complete and !prefixes_of(ends, seq, offset).empty()) {
+            auto prefixes = prefixes_of(ends, seq, offset);
+            uint32_t prefix = *std::max_element(prefixes.begin(), prefixes.end(),
+                [this](const uint32_t a,const uint32_t b) {
+                    const unsigned int a_length = sequences_by_back[a].length, b_length = sequences_by_back[b].length;
+                    return a_length == b_length ? a > b : a_length < b_length;
+                });
+            const handle other_seq = get_by_back(prefix);
+            merge(other_seq, seq, ends, offset);
+            seq = other_seq;
+            complete = sequences[seq].length() >= max_sequence_length;
+        }
+    }
+}
+
+void sequence_vector::merge_parallel(end_index& ends, const int offset) {
+    constexpr uint32_t none = UINT32_MAX;
+    for (bool merged_any = true; merged_any;) {
+        const std::vector<handle> contigs = ordered();
+        std::vector<uint32_t> position(components.size(), none);
+        for (uint32_t contig = 0; contig < contigs.size(); ++contig) {
+            position[contigs[contig].index] = contig;
+        }
+
+        std::vector<uint32_t> successor(contigs.size(), none), predecessor(contigs.size(), none);
+        #pragma omp parallel
+        {
+            const tracer::scope trace("sequence_vector::propose");
+            #pragma omp for schedule(dynamic) nowait
+            for (size_t contig = 0; contig < contigs.size(); ++contig) {
+                auto suffixes = suffixes_of(ends, contigs[contig], offset);
+                if (suffixes.empty()) continue;
+                const uint32_t suffix = *std::max_element(suffixes.begin(), suffixes.end(),
+                    [this](const uint32_t a, const uint32_t b) {
+                        const unsigned int a_length = sequences_by_front[a].length, b_length = sequences_by_front[b].length;
+                        return a_length == b_length ? a > b : a_length < b_length;
+                    }
+                );
+                successor[contig] = position[get_by_front(suffix).index];
+            }
+        }
+
+        for (uint32_t contig = 0; contig < contigs.size(); ++contig) {
+            if (successor[contig] == none) continue;
+            uint32_t& proposer = predecessor[successor[contig]];
+            if (proposer == none) {
+                proposer = contig;
                 continue;
             }
-            merge(seq, other_seq, map, offset);
-            if(seq->length() >= max_sequence_length) {
-                i = sequences.size();
+            const sequence &current = sequences[contigs[proposer]], &candidate = sequences[contigs[contig]];
+            if (candidate.length() > current.length() or (candidate.length() == current.length() and candidate.back() < current.back())) {
+                proposer = contig;
+            }
+        }
+        for (uint32_t contig = 0; contig < contigs.size(); ++contig) {
+            if (successor[contig] != none and predecessor[successor[contig]] != contig) {
+                successor[contig] = none;
+                count("rejected", offset);
             }
         }
 
-        while (map.contains(seq->front()) and !map.get_prefixes(seq->front())->empty() and i < sequences.size()) {
-            const auto& prefixes = map.get_prefixes(seq->front());
-            std::string prefix = *std::max_element(prefixes->begin(), prefixes->end(),
-                [this](const std::string& a,const std::string& b) {
-                    return get_by_back(a)->length() < get_by_back(b)->length();
-                });
-            auto other_seq = get_by_back(prefix);
-            if(seq == other_seq) {
-                std::erase(*prefixes,prefix);
-                std::erase(*map.get_suffixes(prefix), seq->front());
-                continue;
+        std::vector<std::vector<uint32_t>> chains;
+        std::vector<uint8_t> visited(contigs.size());
+        const auto walk = [&](uint32_t contig) {
+            chains.emplace_back();
+            for (; contig != none and !visited[contig]; contig = successor[contig]) {
+                visited[contig] = true;
+                chains.back().push_back(contig);
             }
-            merge(other_seq, seq, map, offset);
-            seq = other_seq;
-            if(seq->length() >= max_sequence_length) {
-                i = sequences.size();
+        };
+        for (uint32_t contig = 0; contig < contigs.size(); ++contig) {
+            if (successor[contig] != none and predecessor[contig] == none) walk(contig);
+        }
+        for (uint32_t contig = 0; contig < contigs.size(); ++contig) {
+            if (successor[contig] != none and !visited[contig]) walk(contig);
+        }
+
+        for (const auto& chain : chains) {
+            const handle head = contigs[chain.front()];
+            for (const uint32_t link : chain | std::views::drop(1)) {
+                merge(head, contigs[link], ends, offset);
             }
+            if (sequences[head].length() >= max_sequence_length) return;
         }
+        merged_any = !chains.empty();
     }
 }
 
-std::vector<std::string> sequence_vector::fronts() const {
-    auto range = sequences_by_front | std::views::keys;
-    std::vector<std::string> keys = std::vector(range.begin(), range.end());
-    return keys;
+void sequence_vector::assemble(end_index& ends, const int offset_limit) {
+    struct candidate {
+        uint8_t offset;
+        unsigned int length;
+        handle from, to;
+    };
+    const auto worse = [](const candidate& a, const candidate& b) {
+        if (a.offset != b.offset) return a.offset > b.offset;
+        if (a.length != b.length) return a.length < b.length;
+        return a.from.index == b.from.index ? a.to.index > b.to.index : a.from.index > b.from.index;
+    };
+
+    const std::vector<handle> contigs = sequences.handles();
+    std::vector<std::vector<candidate>> found(contigs.size());
+    #pragma omp parallel
+    {
+        const tracer::scope trace("sequence_vector::candidates");
+        #pragma omp for schedule(dynamic) nowait
+        for (size_t contig = 0; contig < contigs.size(); ++contig) {
+            const handle from = contigs[contig];
+            const uint32_t back = sequences[from].back();
+            for (const auto& [front, overlap] : ends.overlaps(back)) {
+                const int offset = dictionary[back].length() - overlap;
+                const end_slot& slot = sequences_by_front[front];
+                if (offset >= offset_limit or !slot.present or slot.owner == from) continue;
+                found[contig].push_back({static_cast<uint8_t>(offset), sequences[from].length() + slot.length, from, slot.owner});
+            }
+        }
+    }
+    std::vector<candidate> candidates;
+    for (const auto& partial : found) {
+        candidates.insert(candidates.end(), partial.begin(), partial.end());
+    }
+    std::priority_queue queue(worse, std::move(candidates));
+
+    std::vector<handle> owner(components.size());
+    std::vector<uint8_t> has_successor(components.size()), has_predecessor(components.size());
+    for (const handle contig : contigs) {
+        owner[contig.index] = contig;
+    }
+
+    while (!queue.empty()) {
+        const candidate best = queue.top();
+        queue.pop();
+        if (has_successor[best.from.index] or has_predecessor[best.to.index] or components.connected(best.from.index, best.to.index)) {
+            count("rejected", best.offset);
+            continue;
+        }
+
+        const handle merge_to = owner[components.find(best.from.index)], merged = owner[components.find(best.to.index)];
+        merge(merge_to, merged, ends, best.offset);
+        has_successor[best.from.index] = has_predecessor[best.to.index] = true;
+        owner[components.find(best.from.index)] = merge_to;
+        if (sequences[merge_to].length() >= max_sequence_length) break;
+    }
+}
+
+int sequence_vector::next_offset(const end_index& ends, const int from) {
+    int best = kmer::max_length;
+    for (const handle seq : sequences.handles()) {
+        for (int offset = from; offset < best; ++offset) {
+            if (!suffixes_of(ends, seq, offset).empty() or !prefixes_of(ends, seq, offset).empty()) {
+                best = offset;
+                break;
+            }
+        }
+        if (best == from) break;
+    }
+    return best;
 }
 
-std::vector<std::string> sequence_vector::backs() const {
-    auto range = sequences_by_back | std::views::keys;
-    std::vector<std::string> keys = std::vector(range.begin(), range.end());
+std::vector<uint32_t> sequence_vector::present(const std::vector<end_slot>& ends) {
+    std::vector<uint32_t> keys;
+    for (uint32_t oligo = 0; oligo < ends.size(); ++oligo) {
+        if (ends[oligo].present) keys.push_back(oligo);
+    }
     return keys;
 }
 
+std::vector<uint32_t> sequence_vector::fronts() const {
+    return present(sequences_by_front);
+}
+
+std::vector<uint32_t> sequence_vector::backs() const {
+    return present(sequences_by_back);
+}
+
@@ -1,44 +1,117 @@
 #ifndef SEQUENCE_VECTOR_HPP
 #define SEQUENCE_VECTOR_HPP
 #include <string>
-#include <map>
-#include <memory>
+#include <ranges>
 #include <vector>
 #include "sequence.hpp"
+#include "disjoint_set.hpp"
+#include "end_index.hpp"
 #include "inflection_map.hpp"
+#include "instrumentation.hpp"
+#include "oligo_dictionary.hpp"
+#include "overlap_index.hpp"
+#include "slot_map.hpp"
 #include <set>
 
 class sequence_vector {
 
-    std::vector<std::shared_ptr<sequence>> sequences;
-    std::map<std::string, std::shared_ptr<sequence>> sequences_by_front, sequences_by_back;
+    using handle = slot_map<sequence>::handle;
+
+    struct ranked {
+        unsigned int length;
+        size_t size;
+        uint32_t front;
+        slot_map<sequence>::handle key;
+
+        [[nodiscard]] bool operator<(const ranked& other) const {
+            if (length != other.length) return length > other.length;
+            if (size != other.size) return size < other.size;
+            return front == other.front ? key.index < other.key.index : front < other.front;
+        }
+    };
+
+    struct end_slot {
+        handle owner;
+        unsigned int length;
+        bool present;
+    };
+
+    const oligo_dictionary& dictionary;
+    slot_map<sequence> sequences;
+    std::vector<end_slot> sequences_by_front, sequences_by_back;
+    std::set<ranked> ranking;
+    disjoint_set components{0};
     uint max_sequence_length;
+    size_t removed_nodes = 0;
+    instrumentation* stats = nullptr;
 
-    void merge(const std::shared_ptr<sequence>& merge_to, const std::shared_ptr<sequence>& merged, inflection_map& map, int offset);
+    void count(const std::string_view name, const int offset) {
+        if (stats) stats->count(name, 1, offset);
+    }
+
+    void bind(std::vector<end_slot>& ends, const uint32_t oligo, const handle key) {
+        ends[oligo] = {key, sequences[key].length(), true};
+    }
+
+    [[nodiscard]] static std::vector<uint32_t> present(const std::vector<end_slot>& ends);
+
+    [[nodiscard]] ranked rank_of(const handle key) const {
+        const sequence& seq = sequences[key];
+        return {seq.length(), seq.size(), seq.front(), key};
+    }
+
+    [[nodiscard]] std::vector<handle> ordered() const;
+
+    void merge(handle merge_to, handle merged, end_index& ends, int offset);
+
+    [[nodiscard]] auto suffixes_of(const end_index& ends, const handle seq, const int offset) {
+        return ends.following(sequences[seq].back(), offset)
+            | std::views::filter([this, seq](const uint32_t front) { return get_by_front(front) != seq; });
+    }
+
+    [[nodiscard]] auto prefixes_of(const end_index& ends, const handle seq, const int offset) {
+        return ends.preceding(sequences[seq].front(), offset)
+            | std::views::filter([this, seq](const uint32_t back) { return get_by_back(back) != seq; });
+    }
 
     public:
 
-    sequence_vector(std::vector<std::string>& words, uint origin_length);
+    sequence_vector(const oligo_dictionary& dictionary, const std::vector<uint32_t>& words, uint origin_length);
 
-    void sort();
+    sequence_vector(const oligo_dictionary& dictionary, const std::vector<uint32_t>& words, const overlap_index& overlaps, uint origin_length);
 
-    void merge(inflection_map& map, int offset);
+    sequence_vector(const oligo_dictionary& dictionary, const std::vector<std::vector<uint32_t>>& chains, uint origin_length);
 
-    [[nodiscard]] std::vector<std::string> fronts() const;
+    void merge(end_index& ends, int offset);
 
-    [[nodiscard]] std::vector<std::string> backs() const;
+    // Proposals are found in parallel; accepted joins are applied serially, since each is an
+    // O(1) splice that updates the shared ranking, slot map and disjoint set.
+    void merge_parallel(end_index& ends, int offset);
 
-    std::shared_ptr<sequence> get_by_front(const std::string& key) { return sequences_by_front.at(key); }
+    // Experimental: one global greedy pass scores below the offset loop in merge().
+    void assemble(end_index& ends, int offset_limit);
 
-    std::shared_ptr<sequence> get_by_back(const std::string& key) { return sequences_by_back.at(key); }
+    void instrument(instrumentation& recorder) { stats = &recorder; }
 
-    [[nodiscard]] std::string get_first () const { return sequences.front()->to_string(); }
+    [[nodiscard]] int next_offset(const end_index& ends, int from);
 
-    [[nodiscard]] unsigned int get_first_length() const { return sequences.front()->length(); }
+    [[nodiscard]] std::vector<uint32_t> fronts() const;
+
+    [[nodiscard]] std::vector<uint32_t> backs() const;
+
+    [[nodiscard]] handle get_by_front(const uint32_t key) const { return sequences_by_front[key].owner; }
+
+    [[nodiscard]] handle get_by_back(const uint32_t key) const { return sequences_by_back[key].owner; }
+
+    [[nodiscard]] std::string get_first () const { return sequences[ranking.begin()->key].to_string(); }
+
+    [[nodiscard]] unsigned int get_first_length() const { return ranking.begin()->length; }
 
     [[nodiscard]] auto size() const { return sequences.size(); }
 
-    [[nodiscard]] unsigned int get_first_skipped_count (unsigned int length) { return sequences.front()->get_skipped_count(length); }
+    [[nodiscard]] size_t get_removed_count() const { return removed_nodes; }
+
+    [[nodiscard]] unsigned int get_first_skipped_count (unsigned int length) const { return sequences[ranking.begin()->key].get_skipped_count(length); }
 };
 
 
@@ -0,0 +1,45 @@
+#ifndef SHARDING_HPP
+#define SHARDING_HPP
+
+#include <omp.h>
+#include <vector>
+#include "kmer.hpp"
+#include "tracer.hpp"
+
+constexpr uint8_t shard_bits = 6;
+
+constexpr size_t shard_count = size_t{1} << shard_bits;
+
+[[nodiscard]] inline size_t shard_of(const kmer& key) {
+    return std::hash<kmer>{}(key) * 0x9E3779B97F4A7C15ull >> (64 - shard_bits);
+}
+
+template<typename Shard>
+[[nodiscard]] std::vector<std::vector<size_t>> partition_by_shard(const size_t count, const Shard& shard_of_position) {
+    std::vector<std::vector<std::vector<size_t>>> local(omp_get_max_threads(), std::vector<std::vector<size_t>>(shard_count));
+
+    #pragma omp parallel
+    {
+        const tracer::scope trace("partition_by_shard");
+        auto& buckets = local[omp_get_thread_num()];
+        #pragma omp for schedule(static) nowait
+        for (size_t position = 0; position < count; ++position) {
+            buckets[shard_of_position(position)].push_back(position);
+        }
+    }
+
+    std::vector<std::vector<size_t>> shards(shard_count);
+    #pragma omp parallel
+    {
+        const tracer::scope trace("partition_by_shard merge");
+        #pragma omp for schedule(dynamic) nowait
+        for (size_t shard = 0; shard < shard_count; ++shard) {
+            for (const auto& buckets : local) {
+                shards[shard].insert(shards[shard].end(), buckets[shard].begin(), buckets[shard].end());
+            }
+        }
+    }
+    return shards;
+}
+
+#endif //SHARDING_HPP
@@ -0,0 +1,100 @@
+#ifndef SLOT_MAP_HPP
+#define SLOT_MAP_HPP
+
+#include <cstdint>
+#include <vector>
+
+template<typename T>
+class slot_map {
+
+public:
+
+    struct handle {
+        uint32_t index;
+        uint32_t generation;
+
+        [[nodiscard]] bool operator==(const handle& other) const = default;
+    };
+
+private:
+
+    struct slot {
+        uint32_t position;
+        uint32_t generation;
+    };
+
+    std::vector<T> values;
+    std::vector<uint32_t> owners;
+    std::vector<slot> slots;
+    std::vector<uint32_t> free_slots;
+
+public:
+
+    handle insert(T&& value);
+
+    void erase(handle key);
+
+    [[nodiscard]] bool contains(const handle key) const {
+        return key.index < slots.size() and slots[key.index].generation == key.generation;
+    }
+
+    [[nodiscard]] T& operator[](const handle key) { return values[slots[key.index].position]; }
+
+    [[nodiscard]] const T& operator[](const handle key) const { return values[slots[key.index].position]; }
+
+    [[nodiscard]] handle handle_at(const size_t position) const { return {owners[position], slots[owners[position]].generation}; }
+
+    [[nodiscard]] std::vector<handle> handles() const;
+
+    [[nodiscard]] size_t size() const { return values.size(); }
+
+    void reserve(const size_t count) {
+        values.reserve(count);
+        owners.reserve(count);
+        slots.reserve(count);
+    }
+};
+
+template<typename T>
+typename slot_map<T>::handle slot_map<T>::insert(T&& value) {
+    uint32_t index;
+    if (free_slots.empty()) {
+        index = slots.size();
+        slots.push_back({0, 0});
+    }
+    else {
+        index = free_slots.back();
+        free_slots.pop_back();
+    }
+    slots[index].position = values.size();
+    values.push_back(std::move(value));
+    owners.push_back(index);
+    return {index, slots[index].generation};
+}
+
+template<typename T>
+void slot_map<T>::erase(const handle key) {
+    if (!contains(key)) return;
+    const uint32_t position = slots[key.index].position;
+    if (position + 1 != values.size()) {
+        values[position] = std::move(values.back());
+        owners[position] = owners.back();
+        slots[owners[position]].position = position;
+    }
+    values.pop_back();
+    owners.pop_back();
+    ++slots[key.index].generation;
+    free_slots.push_back(key.index);
+}
+
+template<typename T>
+std::vector<typename slot_map<T>::handle> slot_map<T>::handles() const {
+    std::vector<handle> keys;
+    keys.reserve(values.size());
+    for (size_t position = 0; position < values.size(); ++position) {
+        keys.push_back(handle_at(position));
+    }
+    return keys;
+}
+
+#endif //SLOT_MAP_HPP
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+#include "spectrum_generator.hpp"
+
+namespace {
+    constexpr std::string_view bases = "ACGT";
+}
+
+spectrum_generator::spectrum_generator(const uint8_t oligo_length, const uint64_t seed) : random(seed), oligo_length(oligo_length) {}
+
+spectrum_generator::errors spectrum_generator::parse(const std::string_view name) {
+    if (name == "none") return errors::none;
+    if (name == "repeats") return errors::repeats;
+    if (name == "negative") return errors::negative;
+    if (name == "ends") return errors::ends;
+    if (name == "positive") return errors::positive;
+    throw std::invalid_argument("Unknown error class " + std::string(name));
+}
+
+char spectrum_generator::nucleotide() {
+    return bases[std::uniform_int_distribution<size_t>(0, bases.size() - 1)(random)];
+}
+
+char spectrum_generator::other_than(const char base) {
+    char replacement = base;
+    while (replacement == base) replacement = nucleotide();
+    return replacement;
+}
+
+std::string spectrum_generator::origin(const size_t length, const errors kind, const size_t count) {
+    std::string result(length, 'A');
+    for (char& base : result) {
+        base = nucleotide();
+    }
+    if (kind == errors::repeats and length >= oligo_length) {
+        std::uniform_int_distribution<size_t> position(0, length - oligo_length);
+        for (size_t repeat = 0; repeat < count; ++repeat) {
+            const size_t source = position(random), target = position(random);
+            std::copy_n(result.begin() + source, oligo_length, result.begin() + target);
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> spectrum_generator::oligos(const std::string& origin) const {
+    std::vector<std::string> windows;
+    for (size_t position = 0; position + oligo_length <= origin.size(); ++position) {
+        windows.push_back(origin.substr(position, oligo_length));
+    }
+    return windows;
+}
+
+std::vector<std::string> spectrum_generator::spectrum(const std::string& origin, const errors kind, const size_t count) {
+    std::vector<std::string> result = oligos(origin);
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    if (kind == errors::negative) {
+        std::shuffle(result.begin(), result.end(), random);
+        result.resize(result.size() - std::min(count, result.size()));
+    }
+    else if (kind == errors::ends or kind == errors::positive) {
+        std::unordered_set<std::string> present(result.begin(), result.end());
+        const std::vector<std::string> windows = oligos(origin);
+        std::uniform_int_distribution<size_t> window(0, windows.size() - 1);
+        std::bernoulli_distribution first_end;
+        const size_t attempts = 64 * count;
+        for (size_t added = 0, attempt = 0; added < count and attempt < attempts and !windows.empty(); ++attempt) {
+            std::string oligo(oligo_length, 'A');
+            if (kind == errors::ends) {
+                oligo = windows[window(random)];
+                char& end = first_end(random) ? oligo.front() : oligo.back();
+                end = other_than(end);
+            }
+            else {
+                for (char& base : oligo) {
+                    base = nucleotide();
+                }
+            }
+            if (present.insert(oligo).second) {
+                result.push_back(std::move(oligo));
+                ++added;
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,38 @@
+#ifndef SPECTRUM_GENERATOR_HPP
+#define SPECTRUM_GENERATOR_HPP
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class spectrum_generator {
+
+public:
+
+    enum class errors { none, repeats, negative, ends, positive };
+
+private:
+
+    std::mt19937_64 random;
+    uint8_t oligo_length;
+
+    [[nodiscard]] char nucleotide();
+
+    [[nodiscard]] char other_than(char base);
+
+public:
+
+    explicit spectrum_generator(uint8_t oligo_length = 10, uint64_t seed = 2024);
+
+    [[nodiscard]] static errors parse(std::string_view name);
+
+    [[nodiscard]] std::string origin(size_t length, errors kind = errors::none, size_t count = 0);
+
+    [[nodiscard]] std::vector<std::string> oligos(const std::string& origin) const;
+
+    [[nodiscard]] std::vector<std::string> spectrum(const std::string& origin, errors kind = errors::none, size_t count = 0);
+};
+
+#endif //SPECTRUM_GENERATOR_HPP
@@ -0,0 +1,79 @@
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "tracer.hpp"
+#include <omp.h>
+#include <unistd.h>
+
+namespace {
+    struct event {
+        std::string_view name;
+        tracer::clock::time_point begin, end;
+        int offset;
+        int thread;
+    };
+
+    struct buffer {
+        std::vector<event> events;
+        size_t id;
+    };
+
+    bool active = false;
+    tracer::clock::time_point origin;
+    std::mutex registry_lock;
+    std::vector<std::unique_ptr<buffer>> buffers;
+    thread_local buffer* local = nullptr;
+
+    buffer& local_buffer() {
+        if (!local) {
+            const std::lock_guard guard(registry_lock);
+            buffers.push_back(std::make_unique<buffer>());
+            buffers.back()->id = buffers.size();
+            local = buffers.back().get();
+        }
+        return *local;
+    }
+
+    double microseconds(const tracer::clock::time_point point) {
+        return std::chrono::duration<double, std::micro>(point - origin).count();
+    }
+}
+
+void tracer::enable() {
+    origin = clock::now();
+    active = true;
+}
+
+bool tracer::enabled() {
+    return active;
+}
+
+void tracer::record(const std::string_view name, const clock::time_point begin, const clock::time_point end, const int offset) {
+    local_buffer().events.push_back({name, begin, end, offset, omp_get_thread_num()});
+}
+
+void tracer::dump(const std::string& filename) {
+    std::ofstream output(filename);
+    if (!output) {
+        throw std::runtime_error("Cannot open " + filename + "\n");
+    }
+    const std::lock_guard guard(registry_lock);
+    output << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& thread : buffers) {
+        output << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << getpid() << ",\"tid\":" << thread->id
+            << ",\"args\":{\"name\":\"thread " << thread->id << "\"}}";
+        first = false;
+        for (const auto& [name, begin, end, offset, omp_thread] : thread->events) {
+            output << ",{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":" << getpid() << ",\"tid\":" << thread->id
+                << ",\"ts\":" << microseconds(begin) << ",\"dur\":" << microseconds(end) - microseconds(begin)
+                << ",\"args\":{\"omp_thread\":" << omp_thread;
+            if (offset != no_offset) output << ",\"offset\":" << offset;
+            output << "}}";
+        }
+    }
+    output << "]}\n";
+}
@@ -0,0 +1,45 @@
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+class tracer {
+
+public:
+
+    using clock = std::chrono::steady_clock;
+
+    static constexpr int no_offset = -1;
+
+    class scope {
+
+        std::string_view name;
+        clock::time_point begin;
+
+    public:
+
+        explicit scope(const std::string_view name) : name(name) {
+            if (enabled()) begin = clock::now();
+        }
+
+        scope(const scope&) = delete;
+
+        scope& operator=(const scope&) = delete;
+
+        ~scope() {
+            if (enabled()) record(name, begin, clock::now());
+        }
+    };
+
+    static void enable();
+
+    [[nodiscard]] static bool enabled();
+
+    static void record(std::string_view name, clock::time_point begin, clock::time_point end, int offset = no_offset);
+
+    static void dump(const std::string& filename);
+};
+
+#endif //TRACER_HPP